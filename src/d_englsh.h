@@ -353,6 +353,10 @@
 
 #define STSTR_CHOPPERS  "... doesn't suck - GM"
 #define STSTR_CLEV              "Changing Level..."
+#define STSTR_ZONEON            "Zone Stats ON"
+#define STSTR_ZONEOFF           "Zone Stats OFF"
+#define STSTR_PROFON            "Profile ON"
+#define STSTR_PROFOFF           "Profile OFF"
 
 //
 //      F_Finale.C
@@ -264,6 +264,10 @@
 
 #define STSTR_CHOPPERS          "... DOESN'T SUCK - GM"
 #define STSTR_CLEV              "CHANGEMENT DE NIVEAU..."
+#define STSTR_ZONEON            "STATS MEMOIRE ON"
+#define STSTR_ZONEOFF           "STATS MEMOIRE OFF"
+#define STSTR_PROFON            "PROFIL ON"
+#define STSTR_PROFOFF           "PROFIL OFF"
 
 //
 //      F_Finale.C
@@ -59,8 +59,11 @@ rcsid[] = "$Id: d_main.c,v 1.8 1997/02/03 22:45:09 b1 Exp $";
 #include "f_wipe.h"
 
 #include "m_argv.h"
+#include "m_bench.h"
+#include "m_hash.h"
 #include "m_misc.h"
 #include "m_menu.h"
+#include "m_profile.h"
 
 #include "i_system.h"
 #include "i_sound.h"
@@ -247,7 +250,9 @@ void D_Display (void)
             redrawsbar = true;
         if (inhelpscreensstate && !inhelpscreens)
             redrawsbar = true;              // just put away the help screen
+        M_ProfileStart (ps_stbar);
         ST_Drawer (viewheight == 200, redrawsbar );
+        M_ProfileStop (ps_stbar);
         fullscreen = viewheight == 200;
         break;
 
@@ -272,7 +277,11 @@ void D_Display (void)
         R_RenderPlayerView (&players[displayplayer]);
 
     if (gamestate == GS_LEVEL && gametic)
+    {
+        M_ProfileStart (ps_hud);
         HU_Drawer ();
+        M_ProfileStop (ps_hud);
+    }
 
     // clean up border stuff
     if (gamestate != oldgamestate && gamestate != GS_LEVEL)
@@ -316,14 +325,21 @@ void D_Display (void)
 
 
     // menus go directly to the screen
+    M_ProfileStart (ps_menu);
     M_Drawer ();          // menu is drawn even on top of everything
+    M_ProfileStop (ps_menu);
     NetUpdate ();         // send out any new accumulation
 
+    if (profoverlay && gamestate == GS_LEVEL && !automapactive)
+        M_ProfileDrawer ();
 
     // normal update
     if (!wipe)
     {
+        M_ProfileStart (ps_blit);
         I_FinishUpdate ();              // page flip or blit buffer
+        M_ProfileStop (ps_blit);
+        M_ProfileFrame ();
         return;
     }
 
@@ -344,7 +360,10 @@ void D_Display (void)
                                , 0, 0, SCREENWIDTH, SCREENHEIGHT, tics);
         I_UpdateNoBlit ();
         M_Drawer ();                            // menu is drawn even on top of wipes
+        M_ProfileStart (ps_blit);
         I_FinishUpdate ();                      // page flip or blit buffer
+        M_ProfileStop (ps_blit);
+        M_ProfileFrame ();
     } while (!done);
 }
 
@@ -385,8 +404,10 @@ void D_DoomLoop (void)
             G_BuildTiccmd (&netcmds[consoleplayer][maketic%BACKUPTICS]);
             if (advancedemo)
                 D_DoAdvanceDemo ();
+            M_ProfileStart (ps_tics);
             M_Ticker ();
             G_Ticker ();
+            M_ProfileStop (ps_tics);
             gametic++;
             maketic++;
         }
@@ -400,6 +421,9 @@ void D_DoomLoop (void)
         // Update display, next frame, with current state.
         D_Display ();
 
+        M_BenchFrame ();
+        M_HashFrame ();
+
 #ifndef SNDSERV
         // Sound mixing for the buffer is snychronous.
         I_UpdateSound();
@@ -809,6 +833,7 @@ void FindResponseFile (void)
 void D_DoomMain (void)
 {
     int             p;
+    int             i;
     char                    file[256];
 
     FindResponseFile ();
@@ -963,6 +988,15 @@ void D_DoomMain (void)
         printf("Playing demo %s.lmp.\n",myargv[p+1]);
     }
 
+    // demo files to benchmark, lump names are left as they are
+    p = M_CheckParm ("-benchmark");
+    if (p)
+    {
+        while (++p != myargc && myargv[p][0] != '-')
+            if (strstr (myargv[p], ".lmp"))
+                D_AddFile (myargv[p]);
+    }
+
     // get skill / episode / map from parms
     startskill = sk_medium;
     startepisode = 1;
@@ -1023,6 +1057,35 @@ void D_DoomMain (void)
     printf ("Z_Init: Init zone memory allocation daemon. \n");
     Z_Init ();
 
+    // time the fixed point helpers
+    if (M_CheckParm ("-fixedbench"))
+        M_FixedBench ();
+
+    // print the frame profile every that many frames
+    p = M_CheckParm ("-profile");
+    if (p)
+    {
+        if (p < myargc-1 && myargv[p+1][0] != '-')
+            profreport = atoi (myargv[p+1]);
+        else
+            profreport = 100;
+    }
+
+    // stream zone stats every that many tics
+    p = M_CheckParm ("-zonestats");
+    if (p)
+    {
+        if (p < myargc-1 && myargv[p+1][0] != '-')
+            zstatstics = atoi (myargv[p+1]);
+        else
+            zstatstics = TICRATE;
+    }
+
+    // lump cache budget in KiB, 0 leaves purging to the zone
+    p = M_CheckParm ("-lumpcache");
+    if (p && p < myargc-1)
+        lumpcachebudget = atoi (myargv[p+1])*1024;
+
     printf ("W_Init: Init WADfiles.\n");
     W_InitMultipleFiles (wadfiles);
 
@@ -1138,6 +1201,15 @@ void D_DoomMain (void)
         autostart = true;
     }
 
+    // -framehash out.txt [-framebase baseline.txt], with a demo
+    p = M_CheckParm ("-framehash");
+    if (p && p < myargc-1)
+    {
+        i = M_CheckParm ("-framebase");
+        M_InitFrameHash (myargv[p+1],
+                         i && i < myargc-1 ? myargv[i+1] : NULL);
+    }
+
     p = M_CheckParm ("-playdemo");
     if (p && p < myargc-1)
     {
@@ -1153,6 +1225,16 @@ void D_DoomMain (void)
         D_DoomLoop ();  // never returns
     }
 
+    // -benchmark [demo1 demo2 file.lmp ...] [-benchcsv]
+    p = M_CheckParm ("-benchmark");
+    if (p)
+    {
+        for (i=p+1 ; i<myargc && myargv[i][0] != '-' ; i++)
+            ;
+        M_StartBench (myargv+p+1, i-p-1, M_CheckParm ("-benchcsv"));
+        D_DoomLoop ();  // never returns
+    }
+
     p = M_CheckParm ("-loadgame");
     if (p && p < myargc-1)
     {
@@ -28,6 +28,7 @@ rcsid[] = "$Id: d_net.c,v 1.3 1997/02/03 22:01:47 b1 Exp $";
 
 
 #include "m_menu.h"
+#include "m_profile.h"
 #include "i_system.h"
 #include "i_video.h"
 #include "i_net.h"
@@ -742,8 +743,10 @@ void TryRunTics (void)
                 I_Error ("gametic>lowtic");
             if (advancedemo)
                 D_DoAdvanceDemo ();
+            M_ProfileStart (ps_tics);
             M_Ticker ();
             G_Ticker ();
+            M_ProfileStop (ps_tics);
             gametic++;
 
             // modify command for duplicated tics
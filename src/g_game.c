@@ -34,6 +34,8 @@ rcsid[] = "$Id: g_game.c,v 1.8 1997/02/03 22:45:09 b1 Exp $";
 #include "z_zone.h"
 #include "f_finale.h"
 #include "m_argv.h"
+#include "m_bench.h"
+#include "m_hash.h"
 #include "m_misc.h"
 #include "m_menu.h"
 #include "m_random.h"
@@ -609,6 +611,8 @@ void G_Ticker (void)
     int         buf;
     ticcmd_t*   cmd;
 
+    Z_Ticker ();
+
     // do player reborns if needed
     for (i=0 ; i<MAXPLAYERS ; i++)
         if (playeringame[i] && players[i].playerstate == PST_REBORN)
@@ -1639,7 +1643,10 @@ boolean G_CheckDemoStatus (void)
 {
     int             endtime;
 
-    if (timingdemo)
+    if (framehashing && demoplayback && !benchmarking)
+        M_FrameHashDone ();
+
+    if (timingdemo && !benchmarking)
     {
         endtime = I_GetTime ();
         I_Error ("timed %i gametics in %i realtics",gametic
@@ -1661,7 +1668,10 @@ boolean G_CheckDemoStatus (void)
         fastparm = false;
         nomonsters = false;
         consoleplayer = 0;
-        D_AdvanceDemo ();
+        if (benchmarking)
+            M_BenchDemoDone ();
+        else
+            D_AdvanceDemo ();
         return true;
     }
 
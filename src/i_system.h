@@ -40,11 +40,40 @@ void I_Init (void);
 // for the zone management.
 byte*   I_ZoneBase (int *size);
 
+// Called by W_AddFile.
+// Returns a read-only pointer to the whole content
+// of an open file if the system can address it
+// directly (e.g. XIP flash), NULL if it can't and
+// lumps have to be read in.
+void*   I_MapFile (int handle, int length);
+
+#ifdef RENDERTHREADS
+// Called by R_InitStrips.
+// Starts count threads that each call func (worker number)
+// once per I_RunWorkers. Returns how many could be started.
+int     I_StartWorkers (int count, void (*func) (int worker));
+
+// Runs all workers once, returns when they are all done.
+void    I_RunWorkers (void);
+#endif
+
 
 // Called by D_DoomLoop,
 // returns current time in tics.
 int I_GetTime (void);
 
+// Free running counter for timing code, wraps around.
+// CPU cycles where the port can read them,
+// nanoseconds otherwise.
+unsigned I_GetCycles (void);
+
+// Instructions retired, same rules,
+// 0 where the port can't read them.
+unsigned I_GetInstructions (void);
+
+// What I_GetCycles counts, "cycles" or "ns".
+char*   I_CyclesUnit (void);
+
 
 //
 // Called by D_DoomLoop,
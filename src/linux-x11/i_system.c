@@ -31,10 +31,17 @@ rcsid[] = "$Id: m_bbox.c,v 1.1 1997/02/03 22:45:10 b1 Exp $";
 
 #include <stdarg.h>
 #include <sys/time.h>
+#include <time.h>
+#include <sys/mman.h>
 #include <unistd.h>
 
+#ifdef RENDERTHREADS
+#include <pthread.h>
+#endif
+
 #include "doomdef.h"
 #include "m_misc.h"
+#include "m_argv.h"
 #include "i_video.h"
 #include "i_sound.h"
 
@@ -80,6 +87,112 @@ byte* I_ZoneBase (int*  size)
     return (byte *) malloc (*size);
 }
 
+//
+// I_MapFile
+// Maps the whole WAD read-only, lumps are then served
+//  from the page cache instead of copied into the zone.
+//  -nommap reads them in like before.
+//
+void* I_MapFile (int handle, int length)
+{
+    void*       ptr;
+
+    if (M_CheckParm ("-nommap"))
+        return NULL;
+
+    ptr = mmap (NULL, length, PROT_READ, MAP_SHARED, handle, 0);
+
+    if (ptr == MAP_FAILED)
+        return NULL;
+
+    return ptr;
+}
+
+
+#ifdef RENDERTHREADS
+//
+// Worker threads.
+// Each round, the main thread bumps workerround and waits
+//  for workersbusy to drop back to zero.
+//
+static pthread_mutex_t  workerlock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t   workerstart = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t   workerdone = PTHREAD_COND_INITIALIZER;
+
+static void             (*workerfunc) (int worker);
+static int              numworkers;
+static int              workerround;
+static int              workersbusy;
+
+
+static void* I_WorkerThread (void* arg)
+{
+    int         worker;
+    int         round;
+
+    worker = (int)(long)arg;
+    round = 0;
+
+    for (;;)
+    {
+        pthread_mutex_lock (&workerlock);
+        while (workerround == round)
+            pthread_cond_wait (&workerstart, &workerlock);
+        round = workerround;
+        pthread_mutex_unlock (&workerlock);
+
+        workerfunc (worker);
+
+        pthread_mutex_lock (&workerlock);
+        if (!--workersbusy)
+            pthread_cond_signal (&workerdone);
+        pthread_mutex_unlock (&workerlock);
+    }
+
+    return NULL;
+}
+
+
+//
+// I_StartWorkers
+//
+int I_StartWorkers (int count, void (*func) (int worker))
+{
+    pthread_t   thread;
+
+    workerfunc = func;
+
+    for (numworkers = 0 ; numworkers < count ; numworkers++)
+    {
+        if (pthread_create (&thread, NULL, I_WorkerThread,
+                            (void *)(long)numworkers))
+            break;
+
+        pthread_detach (thread);
+    }
+
+    return numworkers;
+}
+
+
+//
+// I_RunWorkers
+//
+void I_RunWorkers (void)
+{
+    pthread_mutex_lock (&workerlock);
+
+    workersbusy = numworkers;
+    workerround++;
+    pthread_cond_broadcast (&workerstart);
+
+    while (workersbusy)
+        pthread_cond_wait (&workerdone, &workerlock);
+
+    pthread_mutex_unlock (&workerlock);
+}
+#endif
+
 
 
 //
@@ -101,6 +214,37 @@ int  I_GetTime (void)
 }
 
 
+//
+// I_GetCycles
+// nanoseconds, no portable way to read the CPU cycles
+//
+unsigned I_GetCycles (void)
+{
+    struct timespec     ts;
+
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec*1000000000u + ts.tv_nsec;
+}
+
+
+//
+// I_GetInstructions
+//
+unsigned I_GetInstructions (void)
+{
+    return 0;
+}
+
+
+//
+// I_CyclesUnit
+//
+char* I_CyclesUnit (void)
+{
+    return "ns";
+}
+
+
 
 //
 // I_Init
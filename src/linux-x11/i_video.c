@@ -91,6 +91,13 @@ int             doPointerWarp = POINTER_WARP_COUNTDOWN;
 // to use ....
 static int      multiply=1;
 
+// TrueColor output (24/32-bit visuals, or -truecolor).
+// The 8-bit frame in screens[0] is expanded through truepal[]
+// into the 32-bit XImage at blit time.
+static boolean  truecolor;
+static boolean  trueswap;
+static unsigned truepal[256];
+
 
 //
 //  Translates the key currently in X_event
@@ -348,6 +355,265 @@ void I_UpdateNoBlit (void)
     // what is this?
 }
 
+//
+// TrueColor expansion.
+// Each kernel converts count 8-bit pixels from src through
+// truepal[] and writes every result mul times to dst.
+// Only the first line of each block is expanded, the other
+// mul-1 lines are copied from it.
+//
+typedef void (*expandrow_t) (const byte*, unsigned*, int, int);
+
+static expandrow_t  expandrow;
+
+static void
+ExpandRowC
+( const byte*   src,
+  unsigned*     dst,
+  int           count,
+  int           mul )
+{
+    unsigned    p;
+
+    switch (mul)
+    {
+      case 1:
+        while (count--)
+            *dst++ = truepal[*src++];
+        break;
+
+      case 2:
+        while (count--)
+        {
+            p = truepal[*src++];
+            dst[0] = dst[1] = p;
+            dst += 2;
+        }
+        break;
+
+      case 3:
+        while (count--)
+        {
+            p = truepal[*src++];
+            dst[0] = dst[1] = dst[2] = p;
+            dst += 3;
+        }
+        break;
+
+      default:
+        while (count--)
+        {
+            p = truepal[*src++];
+            dst[0] = dst[1] = dst[2] = dst[3] = p;
+            dst += 4;
+        }
+        break;
+    }
+}
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#define X86SIMD
+#include <immintrin.h>
+
+// SSE2 has no gather, the four lookups stay scalar
+// and the replication is done with shuffles.
+__attribute__((target("sse2")))
+static void
+ExpandRowSSE2
+( const byte*   src,
+  unsigned*     dst,
+  int           count,
+  int           mul )
+{
+    __m128i     v;
+    __m128i*    out = (__m128i *) dst;
+    int         n = count >> 2;
+
+#define LOOKUP4(s) _mm_setr_epi32(truepal[(s)[0]], truepal[(s)[1]], \
+                                  truepal[(s)[2]], truepal[(s)[3]])
+
+    switch (mul)
+    {
+      case 1:
+        for ( ; n-- ; src += 4)
+            _mm_storeu_si128(out++, LOOKUP4(src));
+        break;
+
+      case 2:
+        for ( ; n-- ; src += 4)
+        {
+            v = LOOKUP4(src);
+            _mm_storeu_si128(out++, _mm_unpacklo_epi32(v, v));
+            _mm_storeu_si128(out++, _mm_unpackhi_epi32(v, v));
+        }
+        break;
+
+      case 3:
+        for ( ; n-- ; src += 4)
+        {
+            v = LOOKUP4(src);
+            _mm_storeu_si128(out++, _mm_shuffle_epi32(v, _MM_SHUFFLE(1,0,0,0)));
+            _mm_storeu_si128(out++, _mm_shuffle_epi32(v, _MM_SHUFFLE(2,2,1,1)));
+            _mm_storeu_si128(out++, _mm_shuffle_epi32(v, _MM_SHUFFLE(3,3,3,2)));
+        }
+        break;
+
+      default:
+        for ( ; n-- ; src += 4)
+        {
+            v = LOOKUP4(src);
+            _mm_storeu_si128(out++, _mm_shuffle_epi32(v, _MM_SHUFFLE(0,0,0,0)));
+            _mm_storeu_si128(out++, _mm_shuffle_epi32(v, _MM_SHUFFLE(1,1,1,1)));
+            _mm_storeu_si128(out++, _mm_shuffle_epi32(v, _MM_SHUFFLE(2,2,2,2)));
+            _mm_storeu_si128(out++, _mm_shuffle_epi32(v, _MM_SHUFFLE(3,3,3,3)));
+        }
+        break;
+    }
+
+#undef LOOKUP4
+
+    ExpandRowC(src, (unsigned *) out, count & 3, mul);
+}
+
+// AVX2 gathers eight palette entries at once,
+// vpermd spreads them over the output.
+__attribute__((target("avx2")))
+static void
+ExpandRowAVX2
+( const byte*   src,
+  unsigned*     dst,
+  int           count,
+  int           mul )
+{
+    __m256i     v;
+    __m256i     p0, p1, p2, p3;
+    __m256i*    out = (__m256i *) dst;
+    int         n = count >> 3;
+
+#define LOOKUP8(s) _mm256_i32gather_epi32((const int *) truepal,        \
+        _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *) (s))), 4)
+
+    switch (mul)
+    {
+      case 1:
+        for ( ; n-- ; src += 8)
+            _mm256_storeu_si256(out++, LOOKUP8(src));
+        break;
+
+      case 2:
+        p0 = _mm256_setr_epi32(0,0,1,1,2,2,3,3);
+        p1 = _mm256_setr_epi32(4,4,5,5,6,6,7,7);
+        for ( ; n-- ; src += 8)
+        {
+            v = LOOKUP8(src);
+            _mm256_storeu_si256(out++, _mm256_permutevar8x32_epi32(v, p0));
+            _mm256_storeu_si256(out++, _mm256_permutevar8x32_epi32(v, p1));
+        }
+        break;
+
+      case 3:
+        p0 = _mm256_setr_epi32(0,0,0,1,1,1,2,2);
+        p1 = _mm256_setr_epi32(2,3,3,3,4,4,4,5);
+        p2 = _mm256_setr_epi32(5,5,6,6,6,7,7,7);
+        for ( ; n-- ; src += 8)
+        {
+            v = LOOKUP8(src);
+            _mm256_storeu_si256(out++, _mm256_permutevar8x32_epi32(v, p0));
+            _mm256_storeu_si256(out++, _mm256_permutevar8x32_epi32(v, p1));
+            _mm256_storeu_si256(out++, _mm256_permutevar8x32_epi32(v, p2));
+        }
+        break;
+
+      default:
+        p0 = _mm256_setr_epi32(0,0,0,0,1,1,1,1);
+        p1 = _mm256_setr_epi32(2,2,2,2,3,3,3,3);
+        p2 = _mm256_setr_epi32(4,4,4,4,5,5,5,5);
+        p3 = _mm256_setr_epi32(6,6,6,6,7,7,7,7);
+        for ( ; n-- ; src += 8)
+        {
+            v = LOOKUP8(src);
+            _mm256_storeu_si256(out++, _mm256_permutevar8x32_epi32(v, p0));
+            _mm256_storeu_si256(out++, _mm256_permutevar8x32_epi32(v, p1));
+            _mm256_storeu_si256(out++, _mm256_permutevar8x32_epi32(v, p2));
+            _mm256_storeu_si256(out++, _mm256_permutevar8x32_epi32(v, p3));
+        }
+        break;
+    }
+
+#undef LOOKUP8
+
+    ExpandRowC(src, (unsigned *) out, count & 7, mul);
+}
+#endif
+
+
+//
+// InitTrueColor
+// Picks the fastest expander the CPU supports,
+// -nosimd forces the plain C one.
+//
+void InitTrueColor (void)
+{
+    char*       name;
+
+    expandrow = ExpandRowC;
+    name = "C";
+
+#ifdef X86SIMD
+    if (!M_CheckParm("-nosimd"))
+    {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+        {
+            expandrow = ExpandRowAVX2;
+            name = "AVX2";
+        }
+        else if (__builtin_cpu_supports("sse2"))
+        {
+            expandrow = ExpandRowSSE2;
+            name = "SSE2";
+        }
+    }
+#endif
+
+    // the XImage is in the server's byte order
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    trueswap = image->byte_order == LSBFirst;
+#else
+    trueswap = image->byte_order == MSBFirst;
+#endif
+
+    fprintf(stderr, "Using %d-bit TrueColor visual, %s expander\n",
+            X_visualinfo.depth, name);
+}
+
+
+//
+// ExpandTrueColor
+//
+void ExpandTrueColor (void)
+{
+    byte*       src;
+    byte*       dst;
+    int         pitch;
+    int         y;
+    int         i;
+
+    src = screens[0];
+    dst = (byte *) image->data;
+    pitch = image->bytes_per_line;
+
+    for (y=0 ; y<SCREENHEIGHT ; y++)
+    {
+        expandrow(src, (unsigned *) dst, SCREENWIDTH, multiply);
+        for (i=1 ; i<multiply ; i++)
+            memcpy(dst + i*pitch, dst, X_width*4);
+        src += SCREENWIDTH;
+        dst += multiply*pitch;
+    }
+}
+
+
 //
 // I_FinishUpdate
 //
@@ -375,8 +641,11 @@ void I_FinishUpdate (void)
 
     }
 
+    if (truecolor)
+        ExpandTrueColor ();
+
     // scales the screen size before blitting it
-    if (multiply == 2)
+    else if (multiply == 2)
     {
         unsigned int *olineptrs[2];
         unsigned int *ilineptr;
@@ -578,12 +847,51 @@ void UploadNewPalette(Colormap cmap, byte *palette)
         }
 }
 
+//
+// Scales an 8-bit component into one channel of a TrueColor pixel.
+//
+static unsigned TrueChannel (int c, unsigned long mask)
+{
+    int         shift = 0;
+    int         bits = 0;
+
+    if (!mask)
+        return 0;
+
+    while (!(mask & 1)) { mask >>= 1; shift++; }
+    while (mask & 1) { mask >>= 1; bits++; }
+
+    if (bits < 8)
+        c >>= 8 - bits;
+    else
+        c <<= bits - 8;
+
+    return (unsigned) c << shift;
+}
+
+void UploadTruePalette (byte *palette)
+{
+    int         i;
+    unsigned    p;
+
+    for (i=0 ; i<256 ; i++)
+    {
+        p = TrueChannel(gammatable[usegamma][*palette++], X_visualinfo.red_mask);
+        p |= TrueChannel(gammatable[usegamma][*palette++], X_visualinfo.green_mask);
+        p |= TrueChannel(gammatable[usegamma][*palette++], X_visualinfo.blue_mask);
+        truepal[i] = trueswap ? __builtin_bswap32(p) : p;
+    }
+}
+
 //
 // I_SetPalette
 //
 void I_SetPalette (byte* palette)
 {
-    UploadNewPalette(X_cmap, palette);
+    if (truecolor)
+        UploadTruePalette(palette);
+    else
+        UploadNewPalette(X_cmap, palette);
 }
 
 
@@ -767,10 +1075,14 @@ void I_InitGraphics(void)
             I_Error("Could not open display (DISPLAY=[%s])", getenv("DISPLAY"));
     }
 
-    // use the default visual
+    // use an 8-bit PseudoColor visual when there is one,
+    // otherwise expand to 24-bit TrueColor at blit time
     X_screen = DefaultScreen(X_display);
-    if (!XMatchVisualInfo(X_display, X_screen, 8, PseudoColor, &X_visualinfo))
-        I_Error("xdoom currently only supports 256-color PseudoColor screens");
+    truecolor = M_CheckParm("-truecolor")
+        || !XMatchVisualInfo(X_display, X_screen, 8, PseudoColor, &X_visualinfo);
+    if (truecolor
+        && !XMatchVisualInfo(X_display, X_screen, 24, TrueColor, &X_visualinfo))
+        I_Error("xdoom needs a 256-color PseudoColor or 24-bit TrueColor screen");
     X_visual = X_visualinfo.visual;
 
     // check for the MITSHM extension
@@ -793,7 +1105,8 @@ void I_InitGraphics(void)
 
     // create the colormap
     X_cmap = XCreateColormap(X_display, RootWindow(X_display,
-                                                   X_screen), X_visual, AllocAll);
+                                                   X_screen), X_visual,
+                             truecolor ? AllocNone : AllocAll);
 
     // setup attributes for main window
     attribmask = CWEventMask | CWColormap | CWBorderPixel;
@@ -812,7 +1125,7 @@ void I_InitGraphics(void)
                                         x, y,
                                         X_width, X_height,
                                         0, // borderwidth
-                                        8, // depth
+                                        X_visualinfo.depth,
                                         InputOutput,
                                         X_visual,
                                         attribmask,
@@ -860,7 +1173,7 @@ void I_InitGraphics(void)
         // create the image
         image = XShmCreateImage(        X_display,
                                         X_visual,
-                                        8,
+                                        X_visualinfo.depth,
                                         ZPixmap,
                                         0,
                                         &X_shminfo,
@@ -897,19 +1210,28 @@ void I_InitGraphics(void)
     }
     else
     {
+        n = truecolor ? 4 : 1;
         image = XCreateImage(   X_display,
                                 X_visual,
-                                8,
+                                X_visualinfo.depth,
                                 ZPixmap,
                                 0,
-                                (char*)malloc(X_width * X_height),
+                                (char*)malloc(X_width * X_height * n),
                                 X_width, X_height,
-                                8,
-                                X_width );
+                                8*n,
+                                X_width*n );
 
     }
 
-    if (multiply == 1)
+    if (truecolor)
+    {
+        if (image->bits_per_pixel != 32)
+            I_Error("TrueColor needs a 32 bits per pixel XImage, got %d",
+                    image->bits_per_pixel);
+        InitTrueColor ();
+    }
+
+    if (multiply == 1 && !truecolor)
         screens[0] = (unsigned char *) (image->data);
     else
         screens[0] = (unsigned char *) malloc (SCREENWIDTH * SCREENHEIGHT);
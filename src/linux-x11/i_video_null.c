@@ -0,0 +1,164 @@
+// Emacs style mode select   -*- C++ -*-
+//-----------------------------------------------------------------------------
+//
+// $Id:$
+//
+// Copyright (C) 1993-1996 by id Software, Inc.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// $Log:$
+//
+// DESCRIPTION:
+//      Headless video, for benchmarks and frame hashes.
+//      The frame stays in screens[0] and there is no input,
+//       so the game should be driven by a demo
+//       (-timedemo, -playdemo or -benchmark).
+//      -dumpframes prefix writes every frame as prefixNNNNN.ppm.
+//
+//-----------------------------------------------------------------------------
+
+static const char __attribute__((unused))
+rcsid[] = "$Id: i_x.c,v 1.6 1997/02/03 22:45:10 b1 Exp $";
+
+
+#include <stdio.h>
+#include <string.h>
+
+#include "doomstat.h"
+#include "i_system.h"
+#include "v_video.h"
+#include "m_argv.h"
+#include "d_main.h"
+
+#include "doomdef.h"
+
+
+// only kept for dumps
+static byte     palette[256*3];
+
+static char*    dumpprefix;
+static int      dumpframe;
+
+
+
+void I_ShutdownGraphics (void)
+{
+}
+
+
+
+//
+// I_StartFrame
+//
+void I_StartFrame (void)
+{
+}
+
+
+//
+// I_StartTic
+// No input, demos only.
+//
+void I_StartTic (void)
+{
+}
+
+
+//
+// I_UpdateNoBlit
+//
+void I_UpdateNoBlit (void)
+{
+}
+
+
+//
+// I_DumpFrame
+//
+static void I_DumpFrame (void)
+{
+    char        name[256];
+    byte        line[SCREENWIDTH*3];
+    byte*       src;
+    FILE*       f;
+    int         x;
+    int         y;
+
+    sprintf (name, "%s%05d.ppm", dumpprefix, dumpframe++);
+    f = fopen (name, "wb");
+    if (!f)
+        I_Error ("I_DumpFrame: couldn't write %s", name);
+
+    fprintf (f, "P6\n%d %d\n255\n", SCREENWIDTH, SCREENHEIGHT);
+
+    src = screens[0];
+    for (y=0 ; y<SCREENHEIGHT ; y++)
+    {
+        for (x=0 ; x<SCREENWIDTH ; x++)
+            memcpy (line+x*3, palette+*src++*3, 3);
+        fwrite (line, 1, sizeof(line), f);
+    }
+
+    fclose (f);
+}
+
+
+//
+// I_FinishUpdate
+// Nothing to blit, screens[0] is the frame.
+//
+void I_FinishUpdate (void)
+{
+    if (dumpprefix)
+        I_DumpFrame ();
+}
+
+
+//
+// I_ReadScreen
+//
+void I_ReadScreen (byte* scr)
+{
+    memcpy (scr, screens[0], SCREENWIDTH*SCREENHEIGHT);
+}
+
+
+//
+// I_SetPalette
+//
+void I_SetPalette (byte* pal)
+{
+    int         i;
+
+    if (!dumpprefix)
+        return;
+
+    for (i=0 ; i<256*3 ; i++)
+        palette[i] = gammatable[usegamma][*pal++];
+}
+
+
+//
+// I_InitGraphics
+//
+void I_InitGraphics (void)
+{
+    int         p;
+
+    p = M_CheckParm ("-dumpframes");
+    if (p && p < myargc-1)
+        dumpprefix = myargv[p+1];
+
+    printf ("I_InitGraphics: headless%s%s\n",
+            dumpprefix ? ", dumping frames to " : "",
+            dumpprefix ? dumpprefix : "");
+}
@@ -0,0 +1,327 @@
+// Emacs style mode select   -*- C++ -*-
+//-----------------------------------------------------------------------------
+//
+// $Id:$
+//
+// Copyright (C) 1993-1996 by id Software, Inc.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// $Log:$
+//
+// DESCRIPTION:
+//      Timedemo benchmark suite.
+//      Demos are played with G_TimeDemo, one tic per frame and
+//       no waiting. The time between two frames, in I_GetCycles
+//       counts, goes in a log-linear histogram (16 steps per
+//       power of two, so within 6%), from which the percentiles
+//       are taken.
+//
+//-----------------------------------------------------------------------------
+
+static const char __attribute__((unused))
+rcsid[] = "$Id: m_bbox.c,v 1.1 1997/02/03 22:45:10 b1 Exp $";
+
+
+#include <stdio.h>
+#include <string.h>
+
+#include "doomdef.h"
+#include "doomstat.h"
+
+#include "i_system.h"
+#include "g_game.h"
+#include "w_wad.h"
+
+#ifdef __GNUG__
+#pragma implementation "m_bench.h"
+#endif
+#include "m_bench.h"
+
+
+#define MAXBENCHDEMOS   16
+
+// 0-15 exact, then 16 buckets per power of two
+#define HISTSTEPS       16
+#define HISTBUCKETS     ((32-3)*HISTSTEPS)
+
+typedef struct
+{
+    char                name[9];
+
+    int                 frames;
+    int                 gametics;
+    int                 realtics;
+    unsigned long long  total;
+    unsigned            max;
+
+    int                 hist[HISTBUCKETS];
+
+} benchresult_t;
+
+boolean                 benchmarking;
+
+static benchresult_t    benchdemos[MAXBENCHDEMOS];
+static benchresult_t    benchall;
+static int              numbenchdemos;
+static int              benchdemo;
+static boolean          benchcsv;
+
+static unsigned         benchlast;
+static boolean          benchstarted;
+static int              benchstarttic;
+static int              benchstarttime;
+
+static char*            benchdefaults[] = { "demo1", "demo2", "demo3", "demo4" };
+
+
+
+//
+// M_BenchBucket
+//
+static int M_BenchBucket (unsigned v)
+{
+    int         e;
+
+    if (v < HISTSTEPS)
+        return v;
+
+    for (e=0 ; (v >> e) >= 2*HISTSTEPS ; e++)
+        ;
+
+    return (e+1)*HISTSTEPS + ((v >> e) & (HISTSTEPS-1));
+}
+
+
+//
+// M_BenchBucketTop
+// Largest value that lands in the bucket.
+//
+static unsigned M_BenchBucketTop (int b)
+{
+    int         e;
+
+    if (b < HISTSTEPS)
+        return b;
+
+    e = b/HISTSTEPS - 1;
+    return ((unsigned)(HISTSTEPS + (b & (HISTSTEPS-1)) + 1) << e) - 1;
+}
+
+
+//
+// M_BenchAdd
+//
+static void M_BenchAdd (benchresult_t* res, unsigned v)
+{
+    res->frames++;
+    res->total += v;
+    if (v > res->max)
+        res->max = v;
+    res->hist[M_BenchBucket (v)]++;
+}
+
+
+//
+// M_BenchPercentile
+// Top of the bucket holding the pct'th percentile,
+//  no more than the largest time seen.
+//
+static unsigned M_BenchPercentile (benchresult_t* res, int pct)
+{
+    int         want;
+    int         count;
+    int         b;
+
+    if (!res->frames)
+        return 0;
+
+    want = (int)(((long long)res->frames*pct + 99) / 100);
+    count = 0;
+
+    for (b=0 ; b<HISTBUCKETS ; b++)
+    {
+        count += res->hist[b];
+        if (count >= want)
+            break;
+    }
+
+    if (b == HISTBUCKETS || M_BenchBucketTop (b) > res->max)
+        return res->max;
+
+    return M_BenchBucketTop (b);
+}
+
+
+//
+// M_BenchNext
+// Starts the next demo there is a lump for.
+//
+static void M_BenchNext (void)
+{
+    while (benchdemo < numbenchdemos
+           && W_CheckNumForName (benchdemos[benchdemo].name) == -1)
+    {
+        fprintf (stderr, "M_Bench: no demo %s, skipped\n",
+                 benchdemos[benchdemo].name);
+        benchdemo++;
+    }
+
+    if (benchdemo == numbenchdemos)
+        return;
+
+    benchstarted = false;
+    G_TimeDemo (benchdemos[benchdemo].name);
+}
+
+
+//
+// M_StartBench
+//
+void M_StartBench (char** demos, int numdemos, boolean csv)
+{
+    char*       src;
+    char*       base;
+    int         i;
+    int         j;
+
+    if (!numdemos)
+    {
+        demos = benchdefaults;
+        numdemos = sizeof(benchdefaults)/sizeof(*benchdefaults);
+    }
+
+    if (numdemos > MAXBENCHDEMOS)
+        numdemos = MAXBENCHDEMOS;
+
+    // file names were added by D_DoomMain, their lump
+    //  is named after the file, without the extension
+    for (i=0 ; i<numdemos ; i++)
+    {
+        base = demos[i];
+        for (src = demos[i] ; *src ; src++)
+            if (*src == '/' || *src == '\\')
+                base = src+1;
+
+        for (j=0 ; j<8 && base[j] && base[j] != '.' ; j++)
+            benchdemos[i].name[j] = base[j];
+        benchdemos[i].name[j] = 0;
+    }
+
+    strcpy (benchall.name, "all");
+
+    numbenchdemos = numdemos;
+    benchdemo = 0;
+    benchcsv = csv;
+    benchmarking = true;
+
+    M_BenchNext ();
+
+    if (benchdemo == numbenchdemos)
+        I_Error ("M_StartBench: no demo to play");
+}
+
+
+//
+// M_BenchFrame
+// The first frame of a demo loads the level, and
+//  only starts the clock.
+//
+void M_BenchFrame (void)
+{
+    unsigned    now;
+
+    if (!benchmarking || !demoplayback)
+        return;
+
+    now = I_GetCycles ();
+
+    if (!benchstarted)
+    {
+        benchstarted = true;
+        benchstarttic = gametic;
+        benchstarttime = I_GetTime ();
+    }
+    else
+    {
+        M_BenchAdd (&benchdemos[benchdemo], now - benchlast);
+        M_BenchAdd (&benchall, now - benchlast);
+    }
+
+    benchlast = now;
+}
+
+
+//
+// M_BenchPrint
+//
+static void M_BenchPrint (benchresult_t* res, boolean last)
+{
+    unsigned    mean;
+
+    mean = res->frames ? (unsigned)(res->total / res->frames) : 0;
+
+    if (benchcsv)
+    {
+        printf ("%s,%d,%d,%d,%u,%u,%u,%u,%u,%u\n",
+                res->name, res->frames, res->gametics, res->realtics,
+                (unsigned)(res->total / 1000), mean,
+                M_BenchPercentile (res, 50), M_BenchPercentile (res, 95),
+                M_BenchPercentile (res, 99), res->max);
+        return;
+    }
+
+    printf ("  {\"demo\": \"%s\", \"frames\": %d, \"gametics\": %d, "
+            "\"realtics\": %d, \"total_k\": %u, \"mean\": %u, "
+            "\"p50\": %u, \"p95\": %u, \"p99\": %u, \"max\": %u}%s\n",
+            res->name, res->frames, res->gametics, res->realtics,
+            (unsigned)(res->total / 1000), mean,
+            M_BenchPercentile (res, 50), M_BenchPercentile (res, 95),
+            M_BenchPercentile (res, 99), res->max, last ? "" : ",");
+}
+
+
+//
+// M_BenchDemoDone
+//
+void M_BenchDemoDone (void)
+{
+    benchresult_t*      res;
+    int                 i;
+
+    res = &benchdemos[benchdemo];
+    res->gametics = gametic - benchstarttic;
+    res->realtics = I_GetTime () - benchstarttime;
+    benchall.gametics += res->gametics;
+    benchall.realtics += res->realtics;
+
+    benchdemo++;
+    M_BenchNext ();
+
+    if (benchdemo < numbenchdemos)
+        return;
+
+    // all done, times are in I_GetCycles counts
+    if (benchcsv)
+        printf ("demo,frames,gametics,realtics,total_k,mean,p50,p95,p99,max\n");
+    else
+        printf ("{\"unit\": \"%s\", \"results\": [\n", I_CyclesUnit ());
+
+    for (i=0 ; i<numbenchdemos ; i++)
+        if (benchdemos[i].frames)
+            M_BenchPrint (&benchdemos[i], false);
+    M_BenchPrint (&benchall, true);
+
+    if (!benchcsv)
+        printf ("]}\n");
+
+    I_Quit ();
+}
@@ -0,0 +1,56 @@
+// Emacs style mode select   -*- C++ -*-
+//-----------------------------------------------------------------------------
+//
+// $Id:$
+//
+// Copyright (C) 1993-1996 by id Software, Inc.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//      Timedemo benchmark suite.
+//
+//-----------------------------------------------------------------------------
+
+
+#ifndef __M_BENCH__
+#define __M_BENCH__
+
+#include "doomtype.h"
+
+#ifdef __GNUG__
+#pragma interface
+#endif
+
+
+// Set while the suite runs.
+extern boolean          benchmarking;
+
+
+// Called by D_DoomMain.
+// Times the given demo lumps back to back, or demo1 to
+//  demo4 if there are none. Results go to stdout, as JSON
+//  or CSV, then the game quits.
+void M_StartBench (char** demos, int numdemos, boolean csv);
+
+// Called by D_DoomLoop after each frame.
+void M_BenchFrame (void);
+
+// Called by G_CheckDemoStatus when a demo is over.
+void M_BenchDemoDone (void);
+
+
+#endif
+//-----------------------------------------------------------------------------
+//
+// $Log:$
+//
+//-----------------------------------------------------------------------------
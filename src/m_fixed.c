@@ -27,6 +27,7 @@ rcsid[] = "$Id: m_bbox.c,v 1.1 1997/02/03 22:45:10 b1 Exp $";
 
 
 #include "stdlib.h"
+#include "stdio.h"
 
 #include "doomtype.h"
 #include "i_system.h"
@@ -38,51 +39,144 @@ rcsid[] = "$Id: m_bbox.c,v 1.1 1997/02/03 22:45:10 b1 Exp $";
 
 
 
-
-// Fixme. __USE_C_FIXED__ or something.
-
+//
+// FixedDiv2
+// No overflow check, FixedDiv falls back to it
+//  for the cases its fast path doesn't cover.
+//
 fixed_t
-FixedMul
+FixedDiv2
 ( fixed_t       a,
   fixed_t       b )
 {
-    return ((long long) a * (long long) b) >> FRACBITS;
+#if 1
+    long long c;
+    c = ((long long)a<<16) / ((long long)b);
+    return (fixed_t) c;
+#else
+    double c;
+
+    c = ((double)a) / ((double)b) * FRACUNIT;
+
+    if (c >= 2147483648.0 || c < -2147483648.0)
+        I_Error("FixedDiv: divide by zero");
+    return (fixed_t) c;
+#endif
 }
 
 
 
 //
-// FixedDiv, C version.
+// Original out of line versions,
+//  kept as the reference for M_FixedBench.
 //
+static fixed_t __attribute__((noinline))
+FixedMulRef
+( fixed_t       a,
+  fixed_t       b )
+{
+    return ((long long) a * (long long) b) >> FRACBITS;
+}
 
-fixed_t
-FixedDiv
+static fixed_t __attribute__((noinline))
+FixedDivRef
 ( fixed_t       a,
   fixed_t       b )
 {
     if ( (abs(a)>>14) >= abs(b))
         return (a^b)<0 ? MININT : MAXINT;
-    return FixedDiv2 (a,b);
+    return ((long long)a<<16) / ((long long)b);
 }
 
 
 
-fixed_t
-FixedDiv2
-( fixed_t       a,
-  fixed_t       b )
+//
+// M_FixedBench
+// Checks the inlined FixedMul / FixedDiv against the
+//  reference versions, then times both in counts of
+//  I_GetCycles per call (loop overhead included).
+//
+#define BENCHVALUES     1024
+#define BENCHPASSES     64
+
+static fixed_t          benchx[BENCHVALUES];
+static fixed_t          benchy[BENCHVALUES];
+static volatile fixed_t benchsink;
+
+static void M_PrintBench (char* name, unsigned ref, unsigned now)
 {
-#if 1
-    long long c;
-    c = ((long long)a<<16) / ((long long)b);
-    return (fixed_t) c;
-#else
-    double c;
+    unsigned    calls;
 
-    c = ((double)a) / ((double)b) * FRACUNIT;
+    // in hundredths
+    calls = BENCHVALUES*BENCHPASSES;
+    ref = (unsigned)(((unsigned long long)ref*100) / calls);
+    now = (unsigned)(((unsigned long long)now*100) / calls);
 
-    if (c >= 2147483648.0 || c < -2147483648.0)
-        I_Error("FixedDiv: divide by zero");
-    return (fixed_t) c;
-#endif
+    printf ("%s: %d.%02d -> %d.%02d per call\n",
+            name, ref/100, ref%100, now/100, now%100);
+}
+
+void M_FixedBench (void)
+{
+    unsigned    seed;
+    unsigned    start;
+    unsigned    ref;
+    fixed_t     sum;
+    int         pass;
+    int         i;
+
+    // values of every magnitude, both signs
+    seed = 1;
+    for (i=0 ; i<BENCHVALUES ; i++)
+    {
+        seed = seed*1103515245 + 12345;
+        benchx[i] = (int)seed >> (seed & 31);
+        seed = seed*1103515245 + 12345;
+        benchy[i] = (int)seed >> (seed & 31);
+    }
+    benchx[0] = MININT;
+    benchy[1] = MININT;
+    benchy[2] = 0;
+
+    for (i=0 ; i<BENCHVALUES ; i++)
+    {
+        if (FixedMul (benchx[i], benchy[i])
+            != FixedMulRef (benchx[i], benchy[i]))
+            I_Error ("M_FixedBench: FixedMul %x %x",
+                     benchx[i], benchy[i]);
+
+        if (FixedDiv (benchx[i], benchy[i])
+            != FixedDivRef (benchx[i], benchy[i]))
+            I_Error ("M_FixedBench: FixedDiv %x %x",
+                     benchx[i], benchy[i]);
+    }
+
+    // FixedMul
+    sum = 0;
+    start = I_GetCycles ();
+    for (pass=0 ; pass<BENCHPASSES ; pass++)
+        for (i=0 ; i<BENCHVALUES ; i++)
+            sum += FixedMulRef (benchx[i], benchy[i]);
+    ref = I_GetCycles () - start;
+
+    start = I_GetCycles ();
+    for (pass=0 ; pass<BENCHPASSES ; pass++)
+        for (i=0 ; i<BENCHVALUES ; i++)
+            sum += FixedMul (benchx[i], benchy[i]);
+    M_PrintBench ("FixedMul", ref, I_GetCycles () - start);
+
+    // FixedDiv
+    start = I_GetCycles ();
+    for (pass=0 ; pass<BENCHPASSES ; pass++)
+        for (i=0 ; i<BENCHVALUES ; i++)
+            sum += FixedDivRef (benchx[i], benchy[i]);
+    ref = I_GetCycles () - start;
+
+    start = I_GetCycles ();
+    for (pass=0 ; pass<BENCHPASSES ; pass++)
+        for (i=0 ; i<BENCHVALUES ; i++)
+            sum += FixedDiv (benchx[i], benchy[i]);
+    M_PrintBench ("FixedDiv", ref, I_GetCycles () - start);
+
+    benchsink = sum;
 }
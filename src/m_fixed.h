@@ -25,6 +25,8 @@
 #define __M_FIXED__
 
 
+#include "doomtype.h"
+
 #ifdef __GNUG__
 #pragma interface
 #endif
@@ -38,10 +40,128 @@
 
 typedef int fixed_t;
 
-fixed_t FixedMul        (fixed_t a, fixed_t b);
-fixed_t FixedDiv        (fixed_t a, fixed_t b);
 fixed_t FixedDiv2       (fixed_t a, fixed_t b);
 
+// Called by D_DoomMain with -fixedbench.
+void    M_FixedBench    (void);
+
+
+//
+// FixedMul
+// A mul / mulh pair on rv32im.
+//
+static inline fixed_t
+FixedMul
+( fixed_t       a,
+  fixed_t       b )
+{
+    return ((long long) a * (long long) b) >> FRACBITS;
+}
+
+
+#ifndef __LP64__
+//
+// FixedDivU
+// Returns (u<<FRACBITS)/v, for (u>>FRACBITS) < v.
+// Long division by 16 bit digits with a normalised
+//  divisor (divlu, Hacker's Delight 9-4), so 32 bit
+//  targets use two divu instead of calling __divdi3.
+//
+static inline unsigned
+FixedDivU
+( unsigned      u,
+  unsigned      v )
+{
+    int         s;
+    unsigned    vn1, vn0;
+    unsigned    un32, un10, un21;
+    unsigned    q1, q0, rhat;
+
+    // shift v left until its top bit is set
+    s = 0;
+    if (!(v & 0xffff0000)) { s += 16; v <<= 16; }
+    if (!(v & 0xff000000)) { s += 8;  v <<= 8; }
+    if (!(v & 0xf0000000)) { s += 4;  v <<= 4; }
+    if (!(v & 0xc0000000)) { s += 2;  v <<= 2; }
+    if (!(v & 0x80000000)) { s += 1;  v <<= 1; }
+
+    vn1 = v >> 16;
+    vn0 = v & 0xffff;
+
+    // u<<FRACBITS shifted by s too, as two words
+    if (s < 16)
+    {
+        un32 = u >> (16-s);
+        un10 = u << (16+s);
+    }
+    else
+    {
+        un32 = u << (s-16);
+        un10 = 0;
+    }
+
+    // high digit
+    q1 = un32 / vn1;
+    rhat = un32 - q1*vn1;
+
+    while (q1 >= 0x10000 || q1*vn0 > (rhat<<16) + (un10>>16))
+    {
+        q1--;
+        rhat += vn1;
+        if (rhat >= 0x10000)
+            break;
+    }
+
+    un21 = (un32<<16) + (un10>>16) - q1*v;
+
+    // low digit
+    q0 = un21 / vn1;
+    rhat = un21 - q0*vn1;
+
+    while (q0 >= 0x10000 || q0*vn0 > (rhat<<16) + (un10&0xffff))
+    {
+        q0--;
+        rhat += vn1;
+        if (rhat >= 0x10000)
+            break;
+    }
+
+    return (q1<<16) + q0;
+}
+#endif
+
+
+//
+// FixedDiv
+// Saturates instead of overflowing,
+//  same results as the original C version.
+//
+static inline fixed_t
+FixedDiv
+( fixed_t       a,
+  fixed_t       b )
+{
+    int         absa;
+    int         absb;
+
+    absa = a < 0 ? -(unsigned)a : a;
+    absb = b < 0 ? -(unsigned)b : b;
+
+    if ( (absa>>14) >= absb)
+        return (a^b)<0 ? MININT : MAXINT;
+
+#ifdef __LP64__
+    return ((long long)a<<16) / ((long long)b);
+#else
+    // only a == MININT is left negative
+    if (absa < 0)
+        return FixedDiv2 (a,b);
+
+    absa = FixedDivU (absa, absb);
+    return (a^b)<0 ? -absa : absa;
+#endif
+}
+
 
 
 #endif
@@ -0,0 +1,156 @@
+// Emacs style mode select   -*- C++ -*-
+//-----------------------------------------------------------------------------
+//
+// $Id:$
+//
+// Copyright (C) 1993-1996 by id Software, Inc.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// $Log:$
+//
+// DESCRIPTION:
+//      Frame hashes, to check renderer changes are pixel identical.
+//      A 64 bit FNV-1a of screens[0] is written for every frame,
+//       as "frame tic hash" lines. Demos are played one tic
+//       per frame, so two runs of the same demo line up.
+//
+//-----------------------------------------------------------------------------
+
+static const char __attribute__((unused))
+rcsid[] = "$Id: m_bbox.c,v 1.1 1997/02/03 22:45:10 b1 Exp $";
+
+
+#include <stdio.h>
+
+#include "doomdef.h"
+#include "doomstat.h"
+
+#include "i_system.h"
+#include "v_video.h"
+
+#ifdef __GNUG__
+#pragma implementation "m_hash.h"
+#endif
+#include "m_hash.h"
+
+
+#define FNVBASIS        0xcbf29ce484222325ull
+#define FNVPRIME        0x100000001b3ull
+
+boolean                 framehashing;
+
+static FILE*            hashout;
+static FILE*            hashbase;
+static char*            hashbasename;
+static int              hashframes;
+
+
+
+//
+// M_InitFrameHash
+//
+void M_InitFrameHash (char* out, char* baseline)
+{
+    hashout = fopen (out, "w");
+    if (!hashout)
+        I_Error ("M_InitFrameHash: couldn't write %s", out);
+
+    if (baseline)
+    {
+        hashbase = fopen (baseline, "r");
+        if (!hashbase)
+            I_Error ("M_InitFrameHash: couldn't read %s", baseline);
+        hashbasename = baseline;
+    }
+
+    // no skipped or doubled tics
+    singletics = true;
+    framehashing = true;
+}
+
+
+//
+// M_HashFrame
+//
+void M_HashFrame (void)
+{
+    unsigned long long  hash;
+    byte*               src;
+    int                 frame;
+    int                 tic;
+    unsigned            hi;
+    unsigned            lo;
+    unsigned            basehi;
+    unsigned            baselo;
+    int                 i;
+
+    if (!framehashing || !demoplayback)
+        return;
+
+    hash = FNVBASIS;
+    src = screens[0];
+    for (i=0 ; i<SCREENWIDTH*SCREENHEIGHT ; i++)
+    {
+        hash ^= src[i];
+        hash *= FNVPRIME;
+    }
+
+    hi = (unsigned)(hash >> 32);
+    lo = (unsigned)hash;
+
+    fprintf (hashout, "%d %d %08x%08x\n", hashframes, gametic, hi, lo);
+
+    // the first frame that differs is the one to look at
+    if (hashbase)
+    {
+        if (fscanf (hashbase, "%d %d %8x%8x", &frame, &tic, &basehi, &baselo) != 4)
+            I_Error ("M_FrameHash: %s ends before frame %d (tic %d)",
+                     hashbasename, hashframes, gametic);
+
+        if (frame != hashframes || tic != gametic)
+            I_Error ("M_FrameHash: frame %d is at tic %d, %s has it at tic %d",
+                     hashframes, gametic, hashbasename, tic);
+
+        if (basehi != hi || baselo != lo)
+            I_Error ("M_FrameHash: frame %d (tic %d) differs from %s",
+                     hashframes, gametic, hashbasename);
+    }
+
+    hashframes++;
+}
+
+
+//
+// M_FrameHashDone
+//
+void M_FrameHashDone (void)
+{
+    int         frame;
+    int         tic;
+
+    fclose (hashout);
+
+    if (hashbase)
+    {
+        if (fscanf (hashbase, "%d %d", &frame, &tic) == 2)
+            I_Error ("M_FrameHash: demo ended at frame %d, "
+                     "%s goes on to frame %d (tic %d)",
+                     hashframes, hashbasename, frame, tic);
+
+        printf ("M_FrameHash: %d frames match %s\n",
+                hashframes, hashbasename);
+    }
+    else
+        printf ("M_FrameHash: %d frames hashed\n", hashframes);
+
+    I_Quit ();
+}
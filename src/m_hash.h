@@ -0,0 +1,56 @@
+// Emacs style mode select   -*- C++ -*-
+//-----------------------------------------------------------------------------
+//
+// $Id:$
+//
+// Copyright (C) 1993-1996 by id Software, Inc.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//      Frame hashes, to check renderer changes are pixel identical.
+//
+//-----------------------------------------------------------------------------
+
+
+#ifndef __M_HASH__
+#define __M_HASH__
+
+#include "doomtype.h"
+
+#ifdef __GNUG__
+#pragma interface
+#endif
+
+
+// Set by -framehash.
+extern boolean          framehashing;
+
+
+// Called by D_DoomMain.
+// Writes a line per frame to out, and compares with
+//  the baseline written by an earlier run if not NULL.
+void M_InitFrameHash (char* out, char* baseline);
+
+// Called by D_DoomLoop after each D_Display.
+void M_HashFrame (void);
+
+// Called by G_CheckDemoStatus when the demo is over,
+//  reports and quits.
+void M_FrameHashDone (void);
+
+
+#endif
+//-----------------------------------------------------------------------------
+//
+// $Log:$
+//
+//-----------------------------------------------------------------------------
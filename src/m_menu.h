@@ -55,6 +55,10 @@ void M_Init (void);
 // does nothing if menu is already up.
 void M_StartControlPanel (void);
 
+// Writes a string using the hu_font,
+// also used by M_ProfileDrawer.
+void M_WriteText (int x, int y, char *string);
+
 
 
 
@@ -0,0 +1,258 @@
+// Emacs style mode select   -*- C++ -*-
+//-----------------------------------------------------------------------------
+//
+// $Id:$
+//
+// Copyright (C) 1993-1996 by id Software, Inc.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// $Log:$
+//
+// DESCRIPTION:
+//      Per stage frame profiler.
+//      Each stage adds up the counts spent in it during a
+//       frame, M_ProfileFrame then stores them in a ring
+//       of the last PROFFRAMES frames.
+//
+//-----------------------------------------------------------------------------
+
+static const char __attribute__((unused))
+rcsid[] = "$Id: m_bbox.c,v 1.1 1997/02/03 22:45:10 b1 Exp $";
+
+
+#include <stdio.h>
+
+#include "doomdef.h"
+
+#include "i_system.h"
+#include "m_menu.h"
+#include "doomstat.h"
+#include "r_state.h"
+
+#ifdef __GNUG__
+#pragma implementation "m_profile.h"
+#endif
+#include "m_profile.h"
+
+
+// rolling window, power of two
+#define PROFFRAMES      32
+
+// the whole frame, from one M_ProfileFrame to the next
+#define ps_frame        NUMPROFSTAGES
+
+typedef struct
+{
+    char*       name;
+
+    // running for the current frame
+    unsigned    start;
+    unsigned    istart;
+    unsigned    cycles;
+    unsigned    instrs;
+
+    // last frames
+    unsigned    history[PROFFRAMES];
+    unsigned    ihistory[PROFFRAMES];
+
+} profile_t;
+
+static profile_t        profiles[NUMPROFSTAGES+1] =
+{
+    { "bsp" },
+    { "planes" },
+    { "masked" },
+    { "stbar" },
+    { "hud" },
+    { "menu" },
+    { "blit" },
+    { "tics" },
+    { "frame" }
+};
+
+static int              profframe;
+static boolean          profstarted;
+static unsigned         framestart;
+static unsigned         frameistart;
+
+int                     profreport;
+boolean                 profoverlay;
+
+
+
+//
+// M_ProfileStart
+//
+void M_ProfileStart (profstage_t stage)
+{
+    profiles[stage].start = I_GetCycles ();
+    profiles[stage].istart = I_GetInstructions ();
+}
+
+
+//
+// M_ProfileStop
+//
+void M_ProfileStop (profstage_t stage)
+{
+    profile_t*  prof;
+
+    prof = &profiles[stage];
+    prof->cycles += I_GetCycles () - prof->start;
+    prof->instrs += I_GetInstructions () - prof->istart;
+}
+
+
+//
+// M_ProfileFrame
+//
+void M_ProfileFrame (void)
+{
+    profile_t*  prof;
+    unsigned    now;
+    unsigned    inow;
+    int         slot;
+    int         i;
+
+    now = I_GetCycles ();
+    inow = I_GetInstructions ();
+
+    // the first call only starts the frame clock,
+    //  there is no previous frame to measure against
+    if (!profstarted)
+    {
+        profstarted = true;
+        framestart = now;
+        frameistart = inow;
+
+        for (i=0 ; i<NUMPROFSTAGES ; i++)
+            profiles[i].cycles = profiles[i].instrs = 0;
+        return;
+    }
+
+    profiles[ps_frame].cycles = now - framestart;
+    profiles[ps_frame].instrs = inow - frameistart;
+    framestart = now;
+    frameistart = inow;
+
+    slot = profframe & (PROFFRAMES-1);
+
+    for (i=0 ; i<=NUMPROFSTAGES ; i++)
+    {
+        prof = &profiles[i];
+        prof->history[slot] = prof->cycles;
+        prof->ihistory[slot] = prof->instrs;
+        prof->cycles = 0;
+        prof->instrs = 0;
+    }
+
+    profframe++;
+
+    if (profreport && !(profframe % profreport))
+        M_ProfilePrint ();
+}
+
+
+//
+// M_ProfileStats
+// Over the frames in the ring, in thousands.
+//
+static void
+M_ProfileStats
+( profile_t*    prof,
+  int*          min,
+  int*          avg,
+  int*          max,
+  int*          iavg )
+{
+    unsigned    lo;
+    unsigned    hi;
+    unsigned long long  sum;
+    unsigned long long  isum;
+    int         count;
+    int         i;
+
+    count = profframe < PROFFRAMES ? profframe : PROFFRAMES;
+
+    lo = hi = prof->history[0];
+    sum = isum = 0;
+
+    for (i=0 ; i<count ; i++)
+    {
+        if (prof->history[i] < lo)
+            lo = prof->history[i];
+        if (prof->history[i] > hi)
+            hi = prof->history[i];
+        sum += prof->history[i];
+        isum += prof->ihistory[i];
+    }
+
+    *min = lo/1000;
+    *max = hi/1000;
+    *avg = count ? sum/count/1000 : 0;
+    *iavg = count ? isum/count/1000 : 0;
+}
+
+
+//
+// M_ProfilePrint
+//
+void M_ProfilePrint (void)
+{
+    int         min;
+    int         avg;
+    int         max;
+    int         iavg;
+    int         i;
+
+    if (!profframe)
+        return;
+
+    printf ("profile: last %d frames, in thousands\n", PROFFRAMES);
+    printf ("  stage       min      avg      max   instrs\n");
+
+    for (i=0 ; i<=NUMPROFSTAGES ; i++)
+    {
+        M_ProfileStats (&profiles[i], &min, &avg, &max, &iavg);
+        printf ("  %-6s  %7d  %7d  %7d  %7d\n",
+                profiles[i].name, min, avg, max, iavg);
+    }
+}
+
+
+//
+// M_ProfileDrawer
+// Kept inside the view, which is redrawn every frame.
+//
+void M_ProfileDrawer (void)
+{
+    char        buf[40];
+    int         min;
+    int         avg;
+    int         max;
+    int         iavg;
+    int         y;
+    int         i;
+
+    y = viewwindowy;
+
+    for (i=0 ; i<=NUMPROFSTAGES ; i++)
+    {
+        if (y+12 > viewwindowy+viewheight)
+            break;
+
+        M_ProfileStats (&profiles[i], &min, &avg, &max, &iavg);
+        sprintf (buf, "%s %d %d %d", profiles[i].name, min, avg, max);
+        M_WriteText (viewwindowx+2, y+2, buf);
+        y += 12;
+    }
+}
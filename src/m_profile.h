@@ -0,0 +1,77 @@
+// Emacs style mode select   -*- C++ -*-
+//-----------------------------------------------------------------------------
+//
+// $Id:$
+//
+// Copyright (C) 1993-1996 by id Software, Inc.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//      Per stage frame profiler.
+//
+//-----------------------------------------------------------------------------
+
+
+#ifndef __M_PROFILE__
+#define __M_PROFILE__
+
+#include "doomtype.h"
+
+#ifdef __GNUG__
+#pragma interface
+#endif
+
+
+typedef enum
+{
+    ps_bsp,             // R_RenderBSPNode
+    ps_planes,          // R_DrawPlanes
+    ps_masked,          // R_DrawMasked
+    ps_stbar,           // ST_Drawer
+    ps_hud,             // HU_Drawer
+    ps_menu,            // M_Drawer
+    ps_blit,            // I_FinishUpdate
+    ps_tics,            // M_Ticker and G_Ticker
+    NUMPROFSTAGES
+
+} profstage_t;
+
+
+// Frames between reports printed to stdout, 0 for none.
+extern int              profreport;
+
+// Draw the stats over the view.
+extern boolean          profoverlay;
+
+
+// Time spent between the two is added to the stage,
+//  in I_GetCycles (and I_GetInstructions) counts.
+void M_ProfileStart (profstage_t stage);
+void M_ProfileStop (profstage_t stage);
+
+// Called by D_Display once per frame, after the blit.
+void M_ProfileFrame (void);
+
+// Rolling min / avg / max over the last frames,
+//  in thousands of counts.
+void M_ProfilePrint (void);
+
+// Called by D_Display if profoverlay is set.
+void M_ProfileDrawer (void);
+
+
+#endif
+//-----------------------------------------------------------------------------
+//
+// $Log:$
+//
+//-----------------------------------------------------------------------------
@@ -114,6 +114,73 @@ mapthing_t*     deathmatch_p;
 mapthing_t      playerstarts[MAXPLAYERS];
 
 
+// LEVEL ARENA
+// Level geometry is bump allocated out of a single
+//  PU_LEVEL block, sized up front from the map lumps,
+//  in load order (nodes, subsectors and segs end up
+//  next to each other). It is released in one piece
+//  by Z_FreeTags at the next level setup.
+//
+#define ARENAALIGN(s)   (((s) + 7) & ~7)
+
+static byte*    levelarena;
+static int      levelarenasize;
+static int      levelarenaused;
+
+
+//
+// P_InitLevelArena
+//
+static void P_InitLevelArena (int lumpnum)
+{
+    int         size;
+
+    size  = ARENAALIGN(W_LumpLength (lumpnum+ML_BLOCKMAP));
+    size += ARENAALIGN(W_LumpLength (lumpnum+ML_VERTEXES)
+                       / sizeof(mapvertex_t) * sizeof(vertex_t));
+    size += ARENAALIGN(W_LumpLength (lumpnum+ML_SECTORS)
+                       / sizeof(mapsector_t) * sizeof(sector_t));
+    size += ARENAALIGN(W_LumpLength (lumpnum+ML_SIDEDEFS)
+                       / sizeof(mapsidedef_t) * sizeof(side_t));
+    size += ARENAALIGN(W_LumpLength (lumpnum+ML_LINEDEFS)
+                       / sizeof(maplinedef_t) * sizeof(line_t));
+    size += ARENAALIGN(W_LumpLength (lumpnum+ML_NODES)
+                       / sizeof(mapnode_t) * sizeof(node_t));
+    size += ARENAALIGN(W_LumpLength (lumpnum+ML_SSECTORS)
+                       / sizeof(mapsubsector_t) * sizeof(subsector_t));
+    size += ARENAALIGN(W_LumpLength (lumpnum+ML_SEGS)
+                       / sizeof(mapseg_t) * sizeof(seg_t));
+
+    // sector line tables, at most two sectors per line
+    size += ARENAALIGN(W_LumpLength (lumpnum+ML_LINEDEFS)
+                       / sizeof(maplinedef_t) * 2 * sizeof(line_t *));
+
+    levelarena = Z_Malloc (size, PU_LEVEL, 0);
+    levelarenasize = size;
+    levelarenaused = 0;
+}
+
+
+//
+// P_LevelAlloc
+//
+static void* P_LevelAlloc (int size)
+{
+    void*       ptr;
+
+    size = ARENAALIGN(size);
+
+    // should not happen, but don't fail over it
+    if (levelarenaused + size > levelarenasize)
+        return Z_Malloc (size, PU_LEVEL, 0);
+
+    ptr = levelarena + levelarenaused;
+    levelarenaused += size;
+
+    return ptr;
+}
+
+
 
 
 
@@ -132,7 +199,7 @@ void P_LoadVertexes (int lump)
     numvertexes = W_LumpLength (lump) / sizeof(mapvertex_t);
 
     // Allocate zone memory for buffer.
-    vertexes = Z_Malloc (numvertexes*sizeof(vertex_t),PU_LEVEL,0);
+    vertexes = P_LevelAlloc (numvertexes*sizeof(vertex_t));
 
     // Load data into cache.
     data = W_CacheLumpNum (lump,PU_STATIC);
@@ -168,7 +235,7 @@ void P_LoadSegs (int lump)
     int                 side;
 
     numsegs = W_LumpLength (lump) / sizeof(mapseg_t);
-    segs = Z_Malloc (numsegs*sizeof(seg_t),PU_LEVEL,0);
+    segs = P_LevelAlloc (numsegs*sizeof(seg_t));
     memset (segs, 0, numsegs*sizeof(seg_t));
     data = W_CacheLumpNum (lump,PU_STATIC);
 
@@ -208,7 +275,7 @@ void P_LoadSubsectors (int lump)
     subsector_t*        ss;
 
     numsubsectors = W_LumpLength (lump) / sizeof(mapsubsector_t);
-    subsectors = Z_Malloc (numsubsectors*sizeof(subsector_t),PU_LEVEL,0);
+    subsectors = P_LevelAlloc (numsubsectors*sizeof(subsector_t));
     data = W_CacheLumpNum (lump,PU_STATIC);
 
     ms = (mapsubsector_t *)data;
@@ -237,7 +304,7 @@ void P_LoadSectors (int lump)
     sector_t*           ss;
 
     numsectors = W_LumpLength (lump) / sizeof(mapsector_t);
-    sectors = Z_Malloc (numsectors*sizeof(sector_t),PU_LEVEL,0);
+    sectors = P_LevelAlloc (numsectors*sizeof(sector_t));
     memset (sectors, 0, numsectors*sizeof(sector_t));
     data = W_CacheLumpNum (lump,PU_STATIC);
 
@@ -272,7 +339,7 @@ void P_LoadNodes (int lump)
     node_t*     no;
 
     numnodes = W_LumpLength (lump) / sizeof(mapnode_t);
-    nodes = Z_Malloc (numnodes*sizeof(node_t),PU_LEVEL,0);
+    nodes = P_LevelAlloc (numnodes*sizeof(node_t));
     data = W_CacheLumpNum (lump,PU_STATIC);
 
     mn = (mapnode_t *)data;
@@ -365,7 +432,7 @@ void P_LoadLineDefs (int lump)
     vertex_t*           v2;
 
     numlines = W_LumpLength (lump) / sizeof(maplinedef_t);
-    lines = Z_Malloc (numlines*sizeof(line_t),PU_LEVEL,0);
+    lines = P_LevelAlloc (numlines*sizeof(line_t));
     memset (lines, 0, numlines*sizeof(line_t));
     data = W_CacheLumpNum (lump,PU_STATIC);
 
@@ -444,7 +511,7 @@ void P_LoadSideDefs (int lump)
     side_t*             sd;
 
     numsides = W_LumpLength (lump) / sizeof(mapsidedef_t);
-    sides = Z_Malloc (numsides*sizeof(side_t),PU_LEVEL,0);
+    sides = P_LevelAlloc (numsides*sizeof(side_t));
     memset (sides, 0, numsides*sizeof(side_t));
     data = W_CacheLumpNum (lump,PU_STATIC);
 
@@ -472,9 +539,13 @@ void P_LoadBlockMap (int lump)
     int         i;
     int         count;
 
-    blockmaplump = W_CacheLumpNum (lump,PU_LEVEL);
+    // byte swapped in place, so it needs its own copy
+    //  (the cached lump can be directly mapped read-only)
+    count = W_LumpLength (lump);
+    blockmaplump = P_LevelAlloc (count);
+    W_ReadLump (lump, blockmaplump);
     blockmap = blockmaplump+4;
-    count = W_LumpLength (lump)/2;
+    count /= 2;
 
     for (i=0 ; i<count ; i++)
         blockmaplump[i] = SHORT(blockmaplump[i]);
@@ -484,7 +555,8 @@ void P_LoadBlockMap (int lump)
     bmapwidth = blockmaplump[2];
     bmapheight = blockmaplump[3];
 
-    // clear out mobj chains
+    // clear out mobj chains, sized from the header
+    //  just read, so not from the arena
     count = sizeof(*blocklinks)* bmapwidth*bmapheight;
     blocklinks = Z_Malloc (count,PU_LEVEL, 0);
     memset (blocklinks, 0, count);
@@ -534,7 +606,7 @@ void P_GroupLines (void)
     }
 
     // build line tables for each sector
-    linebuffer = Z_Malloc (total*4, PU_LEVEL, 0);
+    linebuffer = P_LevelAlloc (total*sizeof(*linebuffer));
     sector = sectors;
     for (i=0 ; i<numsectors ; i++, sector++)
     {
@@ -646,6 +718,8 @@ P_SetupLevel
 
     leveltime = 0;
 
+    P_InitLevelArena (lumpnum);
+
     // note: most of this ordering is important
     P_LoadBlockMap (lumpnum+ML_BLOCKMAP);
     P_LoadVertexes (lumpnum+ML_VERTEXES);
@@ -653,8 +727,8 @@ P_SetupLevel
     P_LoadSideDefs (lumpnum+ML_SIDEDEFS);
 
     P_LoadLineDefs (lumpnum+ML_LINEDEFS);
-    P_LoadSubsectors (lumpnum+ML_SSECTORS);
     P_LoadNodes (lumpnum+ML_NODES);
+    P_LoadSubsectors (lumpnum+ML_SSECTORS);
     P_LoadSegs (lumpnum+ML_SEGS);
 
     rejectmatrix = W_CacheLumpNum (lumpnum+ML_REJECT,PU_LEVEL);
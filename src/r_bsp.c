@@ -31,6 +31,7 @@ rcsid[] = "$Id: r_bsp.c,v 1.4 1997/02/03 22:45:12 b1 Exp $";
 #include "m_bbox.h"
 
 #include "i_system.h"
+#include "z_zone.h"
 
 #include "r_main.h"
 #include "r_plane.h"
@@ -50,8 +51,9 @@ line_t*         linedef;
 sector_t*       frontsector;
 sector_t*       backsector;
 
-drawseg_t       drawsegs[MAXDRAWSEGS];
+drawseg_t*      drawsegs;
 drawseg_t*      ds_p;
+int             maxdrawsegs;
 
 
 void
@@ -71,6 +73,32 @@ void R_ClearDrawSegs (void)
 }
 
 
+//
+// R_GrowDrawSegs
+// Doubles drawsegs, keeping ds_p in place.
+// Only called from R_StoreWallRange, nothing else
+//  points into drawsegs while the BSP is walked.
+//
+void R_GrowDrawSegs (void)
+{
+    drawseg_t*  newsegs;
+    int         newmax;
+
+    newmax = maxdrawsegs ? maxdrawsegs*2 : MAXDRAWSEGS;
+    newsegs = Z_Malloc (newmax*sizeof(*newsegs), PU_STATIC, 0);
+
+    if (drawsegs)
+    {
+        memcpy (newsegs, drawsegs, maxdrawsegs*sizeof(*newsegs));
+        Z_Free (drawsegs);
+    }
+
+    ds_p = newsegs + (ds_p - drawsegs);
+    drawsegs = newsegs;
+    maxdrawsegs = newmax;
+}
+
+
 
 //
 // ClipWallSegment
@@ -46,8 +46,9 @@ extern boolean          markceiling;
 
 extern boolean          skymap;
 
-extern drawseg_t        drawsegs[MAXDRAWSEGS];
+extern drawseg_t*       drawsegs;
 extern drawseg_t*       ds_p;
+extern int              maxdrawsegs;
 
 extern lighttable_t**   hscalelight;
 extern lighttable_t**   vscalelight;
@@ -60,6 +61,7 @@ typedef void (*drawfunc_t) (int start, int stop);
 // BSP?
 void R_ClearClipSegs (void);
 void R_ClearDrawSegs (void);
+void R_GrowDrawSegs (void);
 
 
 void R_RenderBSPNode (int bspnum);
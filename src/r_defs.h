@@ -458,7 +458,7 @@ typedef struct
 //
 // Now what is a visplane, anyway?
 //
-typedef struct
+typedef struct visplane_s
 {
   fixed_t               height;
   int                   picnum;
@@ -466,6 +466,9 @@ typedef struct
   int                   minx;
   int                   maxx;
 
+  // next plane in the same R_FindPlane hash bucket
+  struct visplane_s*    next;
+
   // leave pads for [minx-1]/[maxx+1]
 
   byte          pad1;
@@ -80,115 +80,22 @@ byte            translations[3][256];
 // R_DrawColumn
 // Source is the top of the column to scale.
 //
-lighttable_t*           dc_colormap;
-int                     dc_x;
-int                     dc_yl;
-int                     dc_yh;
-fixed_t                 dc_iscale;
-fixed_t                 dc_texturemid;
+R_THREADLOCAL lighttable_t*           dc_colormap;
+R_THREADLOCAL int                     dc_x;
+R_THREADLOCAL int                     dc_yl;
+R_THREADLOCAL int                     dc_yh;
+R_THREADLOCAL fixed_t                 dc_iscale;
+R_THREADLOCAL fixed_t                 dc_texturemid;
 
 // first pixel in a column (possibly virtual)
-byte*                   dc_source;
+R_THREADLOCAL byte*                   dc_source;
+
+// height the texture wraps at, set by wall tiers with TALLWALLS
+R_THREADLOCAL int                     dc_texheight = 128;
 
 // just for profiling
 int                     dccount;
 
-//
-// A column is a vertical slice/span from a wall texture that,
-//  given the DOOM style restrictions on the view orientation,
-//  will always have constant z depth.
-// Thus a special case loop for very fast rendering can
-//  be used. It has also been used with Wolfenstein 3D.
-//
-void R_DrawColumn (void)
-{
-    int                 count;
-    byte*               dest;
-    fixed_t             frac;
-    fixed_t             fracstep;
-
-    count = dc_yh - dc_yl;
-
-    // Zero length, column does not exceed a pixel.
-    if (count < 0)
-        return;
-
-#ifdef RANGECHECK
-    if ((unsigned)dc_x >= SCREENWIDTH
-        || dc_yl < 0
-        || dc_yh >= SCREENHEIGHT)
-        I_Error ("R_DrawColumn: %i to %i at %i", dc_yl, dc_yh, dc_x);
-#endif
-
-    // Framebuffer destination address.
-    dest = screens[0] + (viewwindowy + dc_yl) * SCREENWIDTH + (viewwindowx + dc_x);
-
-    // Determine scaling,
-    //  which is the only mapping to be done.
-    fracstep = dc_iscale;
-    frac = dc_texturemid + (dc_yl-centery)*fracstep;
-
-    // Inner loop that does the actual texture mapping,
-    //  e.g. a DDA-lile scaling.
-    // This is as fast as it gets.
-    do
-    {
-        // Re-map color indices from wall texture column
-        //  using a lighting/special effects LUT.
-        *dest = dc_colormap[dc_source[(frac>>FRACBITS)&127]];
-
-        dest += SCREENWIDTH;
-        frac += fracstep;
-
-    } while (count--);
-}
-
-
-
-void R_DrawColumnLow (void)
-{
-    int                 count;
-    byte*               dest;
-    byte*               dest2;
-    fixed_t             frac;
-    fixed_t             fracstep;
-
-    count = dc_yh - dc_yl;
-
-    // Zero length.
-    if (count < 0)
-        return;
-
-#ifdef RANGECHECK
-    if ((unsigned)dc_x >= SCREENWIDTH
-        || dc_yl < 0
-        || dc_yh >= SCREENHEIGHT)
-    {
-
-        I_Error ("R_DrawColumn: %i to %i at %i", dc_yl, dc_yh, dc_x);
-    }
-    //  dccount++;
-#endif
-    // Blocky mode, need to multiply by 2.
-    dc_x <<= 1;
-
-    dest = screens[0] + (viewwindowy + dc_yl) * SCREENWIDTH + (viewwindowx + dc_x);
-    dest2 = dest + 1;
-
-    fracstep = dc_iscale;
-    frac = dc_texturemid + (dc_yl-centery)*fracstep;
-
-    do
-    {
-        // Hack. Does not work corretly.
-        *dest2 = *dest = dc_colormap[dc_source[(frac>>FRACBITS)&127]];
-        dest += SCREENWIDTH;
-        dest2 += SCREENWIDTH;
-        frac += fracstep;
-
-    } while (count--);
-}
-
 
 //
 // Spectre/Invisibility.
@@ -208,104 +115,224 @@ int     fuzzoffset[FUZZTABLE] =
     FUZZOFF,FUZZOFF,-FUZZOFF,FUZZOFF,FUZZOFF,-FUZZOFF,FUZZOFF
 };
 
-int     fuzzpos = 0;
+R_THREADLOCAL int       fuzzpos = 0;
 
 
 //
-// Framebuffer postprocessing.
-// Creates a fuzzy image by copying pixels
-//  from adjacent ones to left and right.
-// Used with an all black colormap, this
-//  could create the SHADOW effect,
-//  i.e. spectres and invisible players.
+// Translation tables are used
+//  to map certain colorramps to other ones,
+//  used with PLAY sprites.
+// Thus the "green" ramp of the player 0 sprite
+//  is mapped to gray, red, black/indigo.
 //
-void R_DrawFuzzColumn (void)
-{
-    int                 count;
-    byte*               dest;
-    fixed_t             frac;
-    fixed_t             fracstep;
+R_THREADLOCAL byte*   dc_translation;
+byte*   translationtables;
 
-    // Adjust borders. Low...
-    if (!dc_yl)
-        dc_yl = 1;
 
-    // .. and high.
-    if (dc_yh == viewheight-1)
-        dc_yh = viewheight - 2;
+//
+// Batched columns.
+// R_QueueColumn draws like R_DrawColumn, but into colbuf,
+//  4 columns wide and row major so it stays in cache.
+// R_FlushColumns then copies a group of 4 columns out,
+//  one 32 bit store per row where all of them overlap.
+// A column can hold several pieces (wall tiers, sprite posts),
+//  as long as they don't overlap, which is always true
+//  within a single seg or sprite.
+//
+#define COLPIECES       16
 
-    count = dc_yh - dc_yl;
+static int      colbuf[SCREENHEIGHT];
+static int      colgroupx = -1;
+static int      colpieces[4];
+static short    colyl[4][COLPIECES];
+static short    colyh[4][COLPIECES];
 
-    // Zero length.
-    if (count < 0)
-        return;
 
+//
+// R_QueueDest
+// Records dc_yl..dc_yh for dc_x and returns where it goes in colbuf.
+//
+static byte* R_QueueDest (void)
+{
+    int                 slot;
 
-#ifdef RANGECHECK
-    if ((unsigned)dc_x >= SCREENWIDTH
-        || dc_yl < 0 || dc_yh >= SCREENHEIGHT)
+    slot = dc_x & 3;
+
+    if ((dc_x & ~3) != colgroupx
+        || colpieces[slot] == COLPIECES)
     {
-        I_Error ("R_DrawFuzzColumn: %i to %i at %i",
-                 dc_yl, dc_yh, dc_x);
+        R_FlushColumns ();
+        colgroupx = dc_x & ~3;
     }
-#endif
 
+    colyl[slot][colpieces[slot]] = dc_yl;
+    colyh[slot][colpieces[slot]] = dc_yh;
+    colpieces[slot]++;
 
-    // Keep till detailshift bug in blocky mode fixed,
-    //  or blocky mode removed.
-    /* WATCOM code
-    if (detailshift)
-    {
-        if (dc_x & 1)
-        {
-            outpw (GC_INDEX,GC_READMAP+(2<<8) );
-            outp (SC_INDEX+1,12);
-        }
-        else
-        {
-            outpw (GC_INDEX,GC_READMAP);
-            outp (SC_INDEX+1,3);
-        }
-        dest = destview + dc_yl*80 + (dc_x>>1);
-    }
-    else
-    {
-        outpw (GC_INDEX,GC_READMAP+((dc_x&3)<<8) );
-        outp (SC_INDEX+1,1<<(dc_x&3));
-        dest = destview + dc_yl*80 + (dc_x>>2);
-    }*/
+    return (byte *)colbuf + dc_yl*4 + slot;
+}
 
 
-    // Does not work with blocky mode.
-    dest = screens[0] + (viewwindowy + dc_yl) * SCREENWIDTH + (viewwindowx + dc_x);
+//
+// A column is a vertical slice/span from a wall texture that,
+//  given the DOOM style restrictions on the view orientation,
+//  will always have constant z depth.
+// Thus a special case loop for very fast rendering can
+//  be used. It has also been used with Wolfenstein 3D.
+//
+// All the column drawers are expansions of R_COLUMNFUNC.
+// Its parameters are constants, so each one compiles down
+//  to just the setup and inner loop it needs:
+//  low         blocky mode, dc_x is doubled, pixels written twice
+//  queue       goes to colbuf for R_FlushColumns (high detail only)
+//  translate   player color ramps, posts are never wrapped
+//  fuzz        Spectre/Invisibility, copies shifted screen pixels
+// Plain ones wrap at 128, or at dc_texheight with TALLWALLS.
+//
+#ifdef RANGECHECK
+#define R_COLUMNCHECK(name)                                     \
+    if ((unsigned)dc_x >= SCREENWIDTH                           \
+        || dc_yl < 0                                            \
+        || dc_yh >= SCREENHEIGHT)                               \
+        I_Error (#name ": %i to %i at %i", dc_yl, dc_yh, dc_x);
+#else
+#define R_COLUMNCHECK(name)
+#endif
 
-    // Looks familiar.
-    fracstep = dc_iscale;
-    frac = dc_texturemid + (dc_yl-centery)*fracstep;
+#define R_COLUMNLOOP(low, pixel, next)                          \
+    do                                                          \
+    {                                                           \
+        dest[0] = pixel;                                        \
+        if (low)                                                \
+            dest[1] = dest[0];                                  \
+        dest += stride;                                         \
+        frac += fracstep;                                       \
+        next;                                                   \
+    } while (count--)
+
+#define R_FUZZPIXEL     colormaps[6*256+dest[fuzzoffset[fuzzpos]]]
+#define R_FUZZNEXT      if (++fuzzpos == FUZZTABLE) fuzzpos = 0
+
+#ifdef TALLWALLS
+// Wall tiers set dc_texheight, so textures that are not 128
+//  high wrap at their own height instead of reading past
+//  the column: other powers of two mask with height-1,
+//  any other height keeps frac in 0..height.
+#define R_PLAINLOOP(low)                                        \
+    if (dc_texheight == 128)                                    \
+        R_COLUMNLOOP(low, colormap[source[(frac>>FRACBITS)&127]], ); \
+    else if (!(dc_texheight & (dc_texheight-1)))                \
+    {                                                           \
+        int     mask = dc_texheight-1;                          \
+        R_COLUMNLOOP(low, colormap[source[(frac>>FRACBITS)&mask]], ); \
+    }                                                           \
+    else                                                        \
+    {                                                           \
+        fixed_t height = dc_texheight<<FRACBITS;                \
+        frac %= height;                                         \
+        if (frac < 0)                                           \
+            frac += height;                                     \
+        R_COLUMNLOOP(low, colormap[source[frac>>FRACBITS]],     \
+                     while (frac >= height) frac -= height);    \
+    }
+#else
+// Everything wraps at 128, as vanilla did.
+#define R_PLAINLOOP(low)                                        \
+    R_COLUMNLOOP(low, colormap[source[(frac>>FRACBITS)&127]], )
+#endif
 
-    // Looks like an attempt at dithering,
-    //  using the colormap #6 (of 0-31, a bit
-    //  brighter than average).
-    do
-    {
-        // Lookup framebuffer, and retrieve
-        //  a pixel that is either one column
-        //  left or right of the current one.
-        // Add index from colormap to index.
-        *dest = colormaps[6*256+dest[fuzzoffset[fuzzpos]]];
+#define R_COLUMNFUNC(name, low, queue, translate, fuzz)         \
+void name (void)                                                \
+{                                                               \
+    int                 count;                                  \
+    int                 stride;                                 \
+    byte*               dest;                                   \
+    byte*               source;                                 \
+    lighttable_t*       colormap;                               \
+    fixed_t             frac;                                   \
+    fixed_t             fracstep;                               \
+                                                                \
+    if (fuzz)                                                   \
+    {                                                           \
+        /* Adjust borders. Low... */                            \
+        if (!dc_yl)                                             \
+            dc_yl = 1;                                          \
+                                                                \
+        /* .. and high. */                                      \
+        if (dc_yh == viewheight-1)                              \
+            dc_yh = viewheight - 2;                             \
+    }                                                           \
+                                                                \
+    count = dc_yh - dc_yl;                                      \
+                                                                \
+    /* Zero length, column does not exceed a pixel. */          \
+    if (count < 0)                                              \
+        return;                                                 \
+                                                                \
+    R_COLUMNCHECK(name)                                         \
+                                                                \
+    if (queue)                                                  \
+    {                                                           \
+        dest = R_QueueDest ();                                  \
+        stride = 4;                                             \
+    }                                                           \
+    else                                                        \
+    {                                                           \
+        dest = screens[0] + (viewwindowy + dc_yl)*SCREENWIDTH   \
+            + viewwindowx + (dc_x << (low));                    \
+        stride = SCREENWIDTH;                                   \
+    }                                                           \
+                                                                \
+    /* Determine scaling, */                                    \
+    /*  which is the only mapping to be done. */                \
+    fracstep = dc_iscale;                                       \
+    frac = dc_texturemid + (dc_yl-centery)*fracstep;            \
+                                                                \
+    source = dc_source;                                         \
+    colormap = dc_colormap;                                     \
+                                                                \
+    if (fuzz)                                                   \
+        R_COLUMNLOOP(low, R_FUZZPIXEL, R_FUZZNEXT);             \
+    else if (translate)                                         \
+        R_COLUMNLOOP(low,                                       \
+            colormap[dc_translation[source[frac>>FRACBITS]]], );\
+    else                                                        \
+        R_PLAINLOOP(low);                                       \
+}
 
-        // Clamp table lookup index.
-        if (++fuzzpos == FUZZTABLE)
-            fuzzpos = 0;
 
-        dest += SCREENWIDTH;
+R_COLUMNFUNC(R_DrawColumn, 0, 0, 0, 0)
+R_COLUMNFUNC(R_DrawColumnLow, 1, 0, 0, 0)
+R_COLUMNFUNC(R_QueueColumn, 0, 1, 0, 0)
 
-        frac += fracstep;
-    } while (count--);
-}
+//
+// Framebuffer postprocessing.
+// Creates a fuzzy image by copying pixels
+//  from adjacent ones to left and right.
+// Used with an all black colormap, this
+//  could create the SHADOW effect,
+//  i.e. spectres and invisible players.
+//
+R_COLUMNFUNC(R_DrawFuzzColumn, 0, 0, 0, 1)
+R_COLUMNFUNC(R_DrawFuzzColumnLow, 1, 0, 0, 1)
 
+//
+// R_SkipFuzzColumn
+// Leaves fuzzpos where R_DrawFuzzColumn would have.
+//
+void R_SkipFuzzColumn (void)
+{
+    int                 yl;
+    int                 yh;
 
+    yl = dc_yl ? dc_yl : 1;
+    yh = dc_yh == viewheight-1 ? viewheight-2 : dc_yh;
 
+    if (yh < yl)
+        return;
+
+    fuzzpos = (fuzzpos + yh - yl + 1) % FUZZTABLE;
+}
 
 //
 // R_DrawTranslatedColumn
@@ -316,71 +343,99 @@ void R_DrawFuzzColumn (void)
 //  of the BaronOfHell, the HellKnight, uses
 //  identical sprites, kinda brightened up.
 //
-byte*   dc_translation;
-byte*   translationtables;
+R_COLUMNFUNC(R_DrawTranslatedColumn, 0, 0, 1, 0)
+R_COLUMNFUNC(R_DrawTranslatedColumnLow, 1, 0, 1, 0)
+
 
-void R_DrawTranslatedColumn (void)
+static void
+R_CopyColumn
+( byte*         base,
+  int           slot,
+  int           yl,
+  int           yh )
 {
-    int                 count;
+    byte*               src;
     byte*               dest;
-    fixed_t             frac;
-    fixed_t             fracstep;
 
-    count = dc_yh - dc_yl;
-    if (count < 0)
-        return;
+    src = (byte *)colbuf + yl*4 + slot;
+    dest = base + yl*SCREENWIDTH + slot;
 
-#ifdef RANGECHECK
-    if ((unsigned)dc_x >= SCREENWIDTH
-        || dc_yl < 0
-        || dc_yh >= SCREENHEIGHT)
+    for ( ; yl<=yh ; yl++)
     {
-        I_Error ( "R_DrawColumn: %i to %i at %i",
-                  dc_yl, dc_yh, dc_x);
+        *dest = *src;
+        src += 4;
+        dest += SCREENWIDTH;
     }
+}
 
-#endif
 
+void R_FlushColumns (void)
+{
+    byte*               base;
+    int                 common;
+    int                 commontop[COLPIECES];
+    int                 commonbot[COLPIECES];
+    int                 slot;
+    int                 i;
+    int                 y;
+    int                 yl;
+    int                 yh;
+
+    if (colgroupx < 0)
+        return;
 
-    // WATCOM VGA specific.
-    /* Keep for fixing.
-    if (detailshift)
-    {
-        if (dc_x & 1)
-            outp (SC_INDEX+1,12);
-        else
-            outp (SC_INDEX+1,3);
+    base = screens[0] + viewwindowy*SCREENWIDTH + viewwindowx + colgroupx;
 
-        dest = destview + dc_yl*80 + (dc_x>>1);
-    }
-    else
+    // pieces of the same rank in all 4 columns share
+    //  the rows they overlap on, copy those a word at a time
+    common = 0;
+
+    if (!((long)base & 3))
     {
-        outp (SC_INDEX+1,1<<(dc_x&3));
+        common = COLPIECES;
+        for (slot=0 ; slot<4 ; slot++)
+            if (colpieces[slot] < common)
+                common = colpieces[slot];
+    }
 
-        dest = destview + dc_yl*80 + (dc_x>>2);
-    }*/
+    for (i=0 ; i<common ; i++)
+    {
+        yl = colyl[0][i];
+        yh = colyh[0][i];
 
+        for (slot=1 ; slot<4 ; slot++)
+        {
+            if (colyl[slot][i] > yl)
+                yl = colyl[slot][i];
+            if (colyh[slot][i] < yh)
+                yh = colyh[slot][i];
+        }
 
-    // FIXME. As above.
-    dest = screens[0] + (viewwindowy + dc_yl) * SCREENWIDTH + (viewwindowx + dc_x);
+        commontop[i] = yl;
+        commonbot[i] = yh;
 
-    // Looks familiar.
-    fracstep = dc_iscale;
-    frac = dc_texturemid + (dc_yl-centery)*fracstep;
+        for (y=yl ; y<=yh ; y++)
+            *(int *)(base + y*SCREENWIDTH) = colbuf[y];
+    }
 
-    // Here we do an additional index re-mapping.
-    do
+    // and the rest a byte at a time
+    for (slot=0 ; slot<4 ; slot++)
     {
-        // Translation tables are used
-        //  to map certain colorramps to other ones,
-        //  used with PLAY sprites.
-        // Thus the "green" ramp of the player 0 sprite
-        //  is mapped to gray, red, black/indigo.
-        *dest = dc_colormap[dc_translation[dc_source[frac>>FRACBITS]]];
-        dest += SCREENWIDTH;
+        for (i=0 ; i<colpieces[slot] ; i++)
+        {
+            if (i < common && commontop[i] <= commonbot[i])
+            {
+                R_CopyColumn (base, slot, colyl[slot][i], commontop[i]-1);
+                R_CopyColumn (base, slot, commonbot[i]+1, colyh[slot][i]);
+            }
+            else
+                R_CopyColumn (base, slot, colyl[slot][i], colyh[slot][i]);
+        }
 
-        frac += fracstep;
-    } while (count--);
+        colpieces[slot] = 0;
+    }
+
+    colgroupx = -1;
 }
 
 
@@ -434,19 +489,19 @@ void R_InitTranslationTables (void)
 // In consequence, flats are not stored by column (like walls),
 //  and the inner loop has to step in texture space u and v.
 //
-int                     ds_y;
-int                     ds_x1;
-int                     ds_x2;
+R_THREADLOCAL int                     ds_y;
+R_THREADLOCAL int                     ds_x1;
+R_THREADLOCAL int                     ds_x2;
 
-lighttable_t*           ds_colormap;
+R_THREADLOCAL lighttable_t*           ds_colormap;
 
-fixed_t                 ds_xfrac;
-fixed_t                 ds_yfrac;
-fixed_t                 ds_xstep;
-fixed_t                 ds_ystep;
+R_THREADLOCAL fixed_t                 ds_xfrac;
+R_THREADLOCAL fixed_t                 ds_yfrac;
+R_THREADLOCAL fixed_t                 ds_xstep;
+R_THREADLOCAL fixed_t                 ds_ystep;
 
 // start of a 64*64 tile image
-byte*                   ds_source;
+R_THREADLOCAL byte*                   ds_source;
 
 // just for profiling
 int                     dscount;
@@ -454,13 +509,94 @@ int                     dscount;
 
 //
 // Draws the actual span.
+//
 void R_DrawSpan (void)
 {
-    fixed_t             xfrac;
-    fixed_t             yfrac;
+#ifdef RANGECHECK
+    if (ds_x2 < ds_x1
+        || ds_x1<0
+        || ds_x2>=SCREENWIDTH
+        || (unsigned)ds_y>SCREENHEIGHT)
+    {
+        I_Error( "R_DrawSpan: %i to %i at %i",
+                 ds_x1,ds_x2,ds_y);
+    }
+//      dscount++;
+#endif
+
+    R_DrawSpanRange (ds_x1, ds_x2);
+}
+
+
+
+#ifdef PACKEDSPANS
+//
+// x and y are packed in one register as 6.10 fixed point,
+//  x in the top half and y in the bottom one, so that a
+//  single add steps both. This is what the DOS asm did too,
+//  at the cost of some sub pixel precision: texels can land
+//  one off on long spans, so this is not the default.
+//
+#define SPANPACK(x,y)   ((((unsigned)(x) << 10) & 0xffff0000) \
+                         | (((unsigned)(y) >> 6) & 0x0000ffff))
+#define SPANSPOT(p)     ((((p) >> 4) & 0x0fc0) | ((p) >> 26))
+
+void R_DrawSpanRange (int x1, int x2)
+{
+    unsigned            position;
+    unsigned            step;
+    byte*               source;
+    lighttable_t*       colormap;
     byte*               dest;
     int                 count;
-    int                 spot;
+
+    step = SPANPACK(ds_xstep, ds_ystep);
+    position = SPANPACK(ds_xfrac, ds_yfrac) + (x1-ds_x1)*step;
+
+    source = ds_source;
+    colormap = ds_colormap;
+
+    dest = screens[0] + (viewwindowy + ds_y) * SCREENWIDTH + (viewwindowx + x1);
+
+    // We do not check for zero spans here?
+    count = x2 - x1 + 1;
+
+    while (count >= 4)
+    {
+        dest[0] = colormap[source[SPANSPOT(position)]];
+        position += step;
+        dest[1] = colormap[source[SPANSPOT(position)]];
+        position += step;
+        dest[2] = colormap[source[SPANSPOT(position)]];
+        position += step;
+        dest[3] = colormap[source[SPANSPOT(position)]];
+        position += step;
+
+        dest += 4;
+        count -= 4;
+    }
+
+    while (count--)
+    {
+        *dest++ = colormap[source[SPANSPOT(position)]];
+        position += step;
+    }
+}
+
+
+
+//
+// Again..
+//
+void R_DrawSpanLow (void)
+{
+    unsigned            position;
+    unsigned            step;
+    byte*               source;
+    lighttable_t*       colormap;
+    byte*               dest;
+    int                 count;
+    int                 pixel;
 
 #ifdef RANGECHECK
     if (ds_x2 < ds_x1
@@ -474,29 +610,99 @@ void R_DrawSpan (void)
 //      dscount++;
 #endif
 
+    position = SPANPACK(ds_xfrac, ds_yfrac);
+    step = SPANPACK(ds_xstep, ds_ystep);
 
-    xfrac = ds_xfrac;
-    yfrac = ds_yfrac;
+    source = ds_source;
+    colormap = ds_colormap;
+
+    // Blocky mode, need to multiply by 2.
+    ds_x1 <<= 1;
+    ds_x2 <<= 1;
 
     dest = screens[0] + (viewwindowy + ds_y) * SCREENWIDTH + (viewwindowx + ds_x1);
 
-    // We do not check for zero spans here?
-    count = ds_x2 - ds_x1;
 
-    do
+    count = ds_x2 - ds_x1 + 1;
+
+    while (count >= 2)
+    {
+        // Lowres/blocky mode does it twice,
+        //  while scale is adjusted appropriately.
+        pixel = colormap[source[SPANSPOT(position)]];
+        position += step;
+        dest[0] = dest[1] = pixel;
+        pixel = colormap[source[SPANSPOT(position)]];
+        position += step;
+        dest[2] = dest[3] = pixel;
+
+        dest += 4;
+        count -= 2;
+    }
+
+    if (count)
     {
-        // Current texture index in u,v.
-        spot = ((yfrac>>(16-6))&(63*64)) + ((xfrac>>16)&63);
+        pixel = colormap[source[SPANSPOT(position)]];
+        dest[0] = dest[1] = pixel;
+    }
+}
+
+#else
+
+// Current texture index in u,v.
+#define SPANSPOT(x,y)   ((((y)>>(16-6))&(63*64)) + (((x)>>16)&63))
+
+void R_DrawSpanRange (int x1, int x2)
+{
+    fixed_t             xfrac;
+    fixed_t             yfrac;
+    fixed_t             xstep;
+    fixed_t             ystep;
+    byte*               source;
+    lighttable_t*       colormap;
+    byte*               dest;
+    int                 count;
+
+    xstep = ds_xstep;
+    ystep = ds_ystep;
+    xfrac = ds_xfrac + (unsigned)(x1-ds_x1)*xstep;
+    yfrac = ds_yfrac + (unsigned)(x1-ds_x1)*ystep;
 
+    source = ds_source;
+    colormap = ds_colormap;
+
+    dest = screens[0] + (viewwindowy + ds_y) * SCREENWIDTH + (viewwindowx + x1);
+
+    // We do not check for zero spans here?
+    count = x2 - x1 + 1;
+
+    while (count >= 4)
+    {
         // Lookup pixel from flat texture tile,
         //  re-index using light/colormap.
-        *dest++ = ds_colormap[ds_source[spot]];
-
-        // Next step in u,v.
-        xfrac += ds_xstep;
-        yfrac += ds_ystep;
+        dest[0] = colormap[source[SPANSPOT(xfrac,yfrac)]];
+        xfrac += xstep;
+        yfrac += ystep;
+        dest[1] = colormap[source[SPANSPOT(xfrac,yfrac)]];
+        xfrac += xstep;
+        yfrac += ystep;
+        dest[2] = colormap[source[SPANSPOT(xfrac,yfrac)]];
+        xfrac += xstep;
+        yfrac += ystep;
+        dest[3] = colormap[source[SPANSPOT(xfrac,yfrac)]];
+        xfrac += xstep;
+        yfrac += ystep;
+
+        dest += 4;
+        count -= 4;
+    }
 
-    } while (count--);
+    while (count--)
+    {
+        *dest++ = colormap[source[SPANSPOT(xfrac,yfrac)]];
+        xfrac += xstep;
+        yfrac += ystep;
+    }
 }
 
 
@@ -537,7 +743,7 @@ void R_DrawSpanLow (void)
     count = ds_x2 - ds_x1;
     do
     {
-        spot = ((yfrac>>(16-6))&(63*64)) + ((xfrac>>16)&63);
+        spot = SPANSPOT(xfrac,yfrac);
         // Lowres/blocky mode does it twice,
         //  while scale is adjusted appropriately.
         *dest++ = ds_colormap[ds_source[spot]];
@@ -548,6 +754,7 @@ void R_DrawSpanLow (void)
 
     } while (count--);
 }
+#endif
 
 //
 // R_InitBuffer
@@ -30,15 +30,28 @@
 #endif
 
 
-extern lighttable_t*    dc_colormap;
-extern int              dc_x;
-extern int              dc_yl;
-extern int              dc_yh;
-extern fixed_t          dc_iscale;
-extern fixed_t          dc_texturemid;
+// The drawer state below is per thread
+//  when columns and spans are drawn by the strip workers.
+#ifdef RENDERTHREADS
+#define R_THREADLOCAL   __thread
+#else
+#define R_THREADLOCAL
+#endif
+
+
+extern R_THREADLOCAL lighttable_t*    dc_colormap;
+extern R_THREADLOCAL int              dc_x;
+extern R_THREADLOCAL int              dc_yl;
+extern R_THREADLOCAL int              dc_yh;
+extern R_THREADLOCAL fixed_t          dc_iscale;
+extern R_THREADLOCAL fixed_t          dc_texturemid;
 
 // first pixel in a column
-extern byte*            dc_source;
+extern R_THREADLOCAL byte*            dc_source;
+
+// texture height the column wraps at,
+//  128 unless a wall tier says otherwise
+extern R_THREADLOCAL int              dc_texheight;
 
 
 // The span blitting interface.
@@ -47,10 +60,20 @@ extern byte*            dc_source;
 void    R_DrawColumn (void);
 void    R_DrawColumnLow (void);
 
+// Same as R_DrawColumn, but batched 4 columns at a time.
+// R_FlushColumns must be called once a seg or sprite is done.
+void    R_QueueColumn (void);
+void    R_FlushColumns (void);
+
 // The Spectre/Invisibility effect.
 void    R_DrawFuzzColumn (void);
 void    R_DrawFuzzColumnLow (void);
 
+// Steps fuzzpos over a column without drawing it.
+void    R_SkipFuzzColumn (void);
+
+extern R_THREADLOCAL int              fuzzpos;
+
 // Draw with color translation tables,
 //  for player sprite rendering,
 //  Green/Red/Blue/Indigo shirts.
@@ -62,28 +85,31 @@ R_VideoErase
 ( unsigned      ofs,
   int           count );
 
-extern int              ds_y;
-extern int              ds_x1;
-extern int              ds_x2;
+extern R_THREADLOCAL int              ds_y;
+extern R_THREADLOCAL int              ds_x1;
+extern R_THREADLOCAL int              ds_x2;
 
-extern lighttable_t*    ds_colormap;
+extern R_THREADLOCAL lighttable_t*    ds_colormap;
 
-extern fixed_t          ds_xfrac;
-extern fixed_t          ds_yfrac;
-extern fixed_t          ds_xstep;
-extern fixed_t          ds_ystep;
+extern R_THREADLOCAL fixed_t          ds_xfrac;
+extern R_THREADLOCAL fixed_t          ds_yfrac;
+extern R_THREADLOCAL fixed_t          ds_xstep;
+extern R_THREADLOCAL fixed_t          ds_ystep;
 
 // start of a 64*64 tile image
-extern byte*            ds_source;
+extern R_THREADLOCAL byte*            ds_source;
 
 extern byte*            translationtables;
-extern byte*            dc_translation;
+extern R_THREADLOCAL byte*            dc_translation;
 
 
 // Span blitting for rows, floor/ceiling.
 // No Sepctre effect needed.
 void    R_DrawSpan (void);
 
+// Only draws x1..x2 of the span, as R_DrawSpan would have.
+void    R_DrawSpanRange (int x1, int x2);
+
 // Low resolution mode, 160x200?
 void    R_DrawSpanLow (void);
 
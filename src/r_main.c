@@ -28,6 +28,7 @@ static const char __attribute__((unused))
 rcsid[] = "$Id: r_main.c,v 1.5 1997/02/03 22:45:12 b1 Exp $";
 
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
 
@@ -39,6 +40,9 @@ rcsid[] = "$Id: r_main.c,v 1.5 1997/02/03 22:45:12 b1 Exp $";
 
 #include "r_local.h"
 #include "r_sky.h"
+#include "r_strip.h"
+
+#include "m_profile.h"
 
 
 
@@ -701,16 +705,22 @@ void R_ExecuteSetViewSize (void)
 
     if (!detailshift)
     {
-        colfunc = basecolfunc = R_DrawColumn;
+        colfunc = basecolfunc = R_QueueColumn;
         fuzzcolfunc = R_DrawFuzzColumn;
         transcolfunc = R_DrawTranslatedColumn;
         spanfunc = R_DrawSpan;
+
+#ifdef RENDERTHREADS
+        // low detail always draws on the main thread
+        if (numstrips)
+            R_StripFuncs ();
+#endif
     }
     else
     {
         colfunc = basecolfunc = R_DrawColumnLow;
-        fuzzcolfunc = R_DrawFuzzColumn;
-        transcolfunc = R_DrawTranslatedColumn;
+        fuzzcolfunc = R_DrawFuzzColumnLow;
+        transcolfunc = R_DrawTranslatedColumnLow;
         spanfunc = R_DrawSpanLow;
     }
 
@@ -789,6 +799,14 @@ void R_Init (void)
     printf ("\nR_InitSkyMap");
     R_InitTranslationTables ();
     printf ("\nR_InitTranslationsTables");
+#ifdef RENDERTHREADS
+    R_InitStrips ();
+#endif
+#ifdef DEFERWALLS
+    // after R_InitStrips, the purge hooks are chained
+    R_InitWalls ();
+    printf ("\nR_InitWalls");
+#endif
 
     framecount = 0;
 }
@@ -864,6 +882,58 @@ void R_SetupFrame (player_t* player)
 
 
 
+//
+// Pool usage of the last frame,
+//  and the most seen since startup.
+//
+int                     visplanesused;
+int                     drawsegsused;
+int                     visspritesused;
+int                     openingsused;
+
+int                     visplanesmax;
+int                     drawsegsmax;
+int                     visspritesmax;
+int                     openingsmax;
+
+
+//
+// R_UpdateStats
+//
+static void R_UpdateStats (void)
+{
+    visplanesused = numvisplanes;
+    drawsegsused = ds_p - drawsegs;
+    visspritesused = vissprite_p - vissprites;
+    openingsused = R_OpeningsUsed ();
+
+    if (visplanesused > visplanesmax)
+        visplanesmax = visplanesused;
+    if (drawsegsused > drawsegsmax)
+        drawsegsmax = drawsegsused;
+    if (visspritesused > visspritesmax)
+        visspritesmax = visspritesused;
+    if (openingsused > openingsmax)
+        openingsmax = openingsused;
+}
+
+
+//
+// R_PrintStats
+// Renderer pool usage on stderr, next to Z_PrintStats.
+//
+void R_PrintStats (void)
+{
+    fprintf (stderr, "render: visplanes %i/%i (max %i) drawsegs %i/%i (max %i)\n",
+             visplanesused, maxvisplanes, visplanesmax,
+             drawsegsused, maxdrawsegs, drawsegsmax);
+    fprintf (stderr, "render: vissprites %i/%i (max %i) openings %i (max %i)\n",
+             visspritesused, maxvissprites, visspritesmax,
+             openingsused, openingsmax);
+}
+
+
+
 //
 // R_RenderView
 //
@@ -881,18 +951,36 @@ void R_RenderPlayerView (player_t* player)
     NetUpdate ();
 
     // The head node is the last node output.
+    M_ProfileStart (ps_bsp);
     R_RenderBSPNode (numnodes-1);
 
+#ifdef DEFERWALLS
+    R_DrawWalls ();
+#endif
+    M_ProfileStop (ps_bsp);
+
     // Check for new console commands.
     NetUpdate ();
 
+    M_ProfileStart (ps_planes);
     R_DrawPlanes ();
+    M_ProfileStop (ps_planes);
 
     // Check for new console commands.
     NetUpdate ();
 
+    M_ProfileStart (ps_masked);
     R_DrawMasked ();
 
+#ifdef RENDERTHREADS
+    // strips must be done before anything else draws,
+    //  with threads most of the drawing shows up here
+    R_FlushStrips ();
+#endif
+    M_ProfileStop (ps_masked);
+
+    R_UpdateStats ();
+
     // Check for new console commands.
     NetUpdate ();
 }
@@ -101,6 +101,7 @@ extern  int             detailshift;
 extern void             (*colfunc) (void);
 extern void             (*basecolfunc) (void);
 extern void             (*fuzzcolfunc) (void);
+extern void             (*transcolfunc) (void);
 // No shadow effects on floors.
 extern void             (*spanfunc) (void);
 
@@ -159,6 +160,19 @@ R_AddPointToBox
 // Called by G_Drawer.
 void R_RenderPlayerView (player_t *player);
 
+// Pool usage of the last frame, and high-water marks.
+extern int              visplanesused;
+extern int              drawsegsused;
+extern int              visspritesused;
+extern int              openingsused;
+
+extern int              visplanesmax;
+extern int              drawsegsmax;
+extern int              visspritesmax;
+extern int              openingsmax;
+
+void R_PrintStats (void);
+
 // Called by startup code.
 void R_Init (void);
 
@@ -45,20 +45,39 @@ rcsid[] = "$Id: r_plane.c,v 1.4 1997/02/03 16:47:55 b1 Exp $";
 planefunction_t         floorfunc;
 planefunction_t         ceilingfunc;
 
+//
+// R_FindPlane hash, only holds the planes it created.
+//
+#define VISPLANEHASHSIZE        256
+static visplane_t*      visplanehash[VISPLANEHASHSIZE];
+
 //
 // opening
 //
 
 // Here comes the obnoxious "visplane".
+// Planes are allocated as needed and kept from frame to frame,
+// visplanes[] only holds pointers so it can be grown mid frame.
 #define MAXVISPLANES    128
-visplane_t              visplanes[MAXVISPLANES];
-visplane_t*             lastvisplane;
+visplane_t**            visplanes;
+int                     numvisplanes;
+int                     maxvisplanes;
 visplane_t*             floorplane;
 visplane_t*             ceilingplane;
 
-// ?
+// Sprite clip and masked column tables of the drawsegs.
+// Chained so they never move once handed out.
 #define MAXOPENINGS     SCREENWIDTH*64
-short                   openings[MAXOPENINGS];
+
+typedef struct openingchunk_s
+{
+    struct openingchunk_s*      next;
+    short                       openings[MAXOPENINGS];
+} openingchunk_t;
+
+static openingchunk_t*  firstopenings;
+static openingchunk_t*  curopenings;
+static int              openingsbase;
 short*                  lastopening;
 
 
@@ -101,7 +120,115 @@ fixed_t                 cachedystep[SCREENHEIGHT];
 //
 void R_InitPlanes (void)
 {
-  // Doh!
+    R_GrowPlanes ();
+
+    firstopenings = Z_Malloc (sizeof(*firstopenings), PU_STATIC, 0);
+    firstopenings->next = NULL;
+}
+
+
+//
+// R_CheckOpenings
+// Makes room for count entries at lastopening,
+//  moving on to the next chunk if needed.
+//
+void R_CheckOpenings (int count)
+{
+    openingchunk_t*     chunk;
+
+    if (lastopening + count <= curopenings->openings + MAXOPENINGS)
+        return;
+
+    if (!curopenings->next)
+    {
+        chunk = Z_Malloc (sizeof(*chunk), PU_STATIC, 0);
+        chunk->next = NULL;
+        curopenings->next = chunk;
+    }
+
+    openingsbase += lastopening - curopenings->openings;
+    curopenings = curopenings->next;
+    lastopening = curopenings->openings;
+}
+
+
+//
+// R_OpeningsUsed
+//
+int R_OpeningsUsed (void)
+{
+    return openingsbase + (lastopening - curopenings->openings);
+}
+
+
+//
+// R_GrowPlanes
+// Doubles the number of visplanes.
+// Bottom is cleared once here, top gets reset as planes widen.
+//
+void R_GrowPlanes (void)
+{
+    visplane_t**        newplanes;
+    visplane_t*         chunk;
+    int                 newmax;
+    int                 i;
+
+    newmax = maxvisplanes ? maxvisplanes*2 : MAXVISPLANES;
+
+    newplanes = Z_Malloc (newmax*sizeof(*newplanes), PU_STATIC, 0);
+    if (visplanes)
+    {
+        memcpy (newplanes, visplanes, maxvisplanes*sizeof(*newplanes));
+        Z_Free (visplanes);
+    }
+
+    chunk = Z_Malloc ((newmax-maxvisplanes)*sizeof(*chunk), PU_STATIC, 0);
+    memset (chunk, 0, (newmax-maxvisplanes)*sizeof(*chunk));
+
+    for (i=maxvisplanes ; i<newmax ; i++)
+        newplanes[i] = chunk++;
+
+    visplanes = newplanes;
+    maxvisplanes = newmax;
+}
+
+
+//
+// R_NewPlane
+//
+static visplane_t*
+R_NewPlane
+( fixed_t       height,
+  int           picnum,
+  int           lightlevel )
+{
+    visplane_t* pl;
+
+    if (numvisplanes == maxvisplanes)
+        R_GrowPlanes ();
+
+    pl = visplanes[numvisplanes++];
+    pl->height = height;
+    pl->picnum = picnum;
+    pl->lightlevel = lightlevel;
+    pl->next = NULL;
+
+    return pl;
+}
+
+
+//
+// R_ClearPlaneTop
+// Marks top[x1..x2] as not drawn.
+//
+static void
+R_ClearPlaneTop
+( visplane_t*   pl,
+  int           x1,
+  int           x2 )
+{
+    if (x1 <= x2)
+        memset (pl->top+x1, 0xff, x2-x1+1);
 }
 
 
@@ -195,8 +322,11 @@ void R_ClearPlanes (void)
         ceilingclip[i] = -1;
     }
 
-    lastvisplane = visplanes;
-    lastopening = openings;
+    numvisplanes = 0;
+    memset (visplanehash, 0, sizeof(visplanehash));
+    curopenings = firstopenings;
+    lastopening = curopenings->openings;
+    openingsbase = 0;
 
     // texture calculation
     memset (cachedheight, 0, sizeof(cachedheight));
@@ -214,6 +344,8 @@ void R_ClearPlanes (void)
 
 //
 // R_FindPlane
+// Only ever returns the first plane of a given kind, like the
+// linear search used to, the splits made by R_CheckPlane are not hashed.
 //
 visplane_t*
 R_FindPlane
@@ -222,6 +354,7 @@ R_FindPlane
   int           lightlevel )
 {
     visplane_t* check;
+    unsigned    hash;
 
     if (picnum == skyflatnum)
     {
@@ -229,32 +362,25 @@ R_FindPlane
         lightlevel = 0;
     }
 
-    for (check=visplanes; check<lastvisplane; check++)
+    hash = ((height>>FRACBITS)*7 + picnum*3 + lightlevel)
+        & (VISPLANEHASHSIZE-1);
+
+    for (check=visplanehash[hash] ; check ; check=check->next)
     {
         if (height == check->height
             && picnum == check->picnum
             && lightlevel == check->lightlevel)
         {
-            break;
+            return check;
         }
     }
 
-
-    if (check < lastvisplane)
-        return check;
-
-    if (lastvisplane - visplanes == MAXVISPLANES)
-        I_Error ("R_FindPlane: no more visplanes");
-
-    lastvisplane++;
-
-    check->height = height;
-    check->picnum = picnum;
-    check->lightlevel = lightlevel;
+    check = R_NewPlane (height, picnum, lightlevel);
     check->minx = SCREENWIDTH;
     check->maxx = -1;
 
-    memset (check->top,0xff,sizeof(check->top));
+    check->next = visplanehash[hash];
+    visplanehash[hash] = check;
 
     return check;
 }
@@ -303,6 +429,15 @@ R_CheckPlane
 
     if (x > intrh)
     {
+        // only the columns the plane grows by need resetting
+        if (pl->minx > pl->maxx)
+            R_ClearPlaneTop (pl, start, stop);
+        else
+        {
+            R_ClearPlaneTop (pl, unionl, pl->minx-1);
+            R_ClearPlaneTop (pl, pl->maxx+1, unionh);
+        }
+
         pl->minx = unionl;
         pl->maxx = unionh;
 
@@ -311,15 +446,11 @@ R_CheckPlane
     }
 
     // make a new visplane
-    lastvisplane->height = pl->height;
-    lastvisplane->picnum = pl->picnum;
-    lastvisplane->lightlevel = pl->lightlevel;
-
-    pl = lastvisplane++;
+    pl = R_NewPlane (pl->height, pl->picnum, pl->lightlevel);
     pl->minx = start;
     pl->maxx = stop;
 
-    memset (pl->top,0xff,sizeof(pl->top));
+    R_ClearPlaneTop (pl, start, stop);
 
     return pl;
 }
@@ -368,27 +499,16 @@ R_MakeSpans
 void R_DrawPlanes (void)
 {
     visplane_t*         pl;
+    int                 i;
     int                 light;
     int                 x;
     int                 stop;
     int                 angle;
 
-#ifdef RANGECHECK
-    if (ds_p - drawsegs > MAXDRAWSEGS)
-        I_Error ("R_DrawPlanes: drawsegs overflow (%i)",
-                 ds_p - drawsegs);
-
-    if (lastvisplane - visplanes > MAXVISPLANES)
-        I_Error ("R_DrawPlanes: visplane overflow (%i)",
-                 lastvisplane - visplanes);
-
-    if (lastopening - openings > MAXOPENINGS)
-        I_Error ("R_DrawPlanes: opening overflow (%i)",
-                 lastopening - openings);
-#endif
-
-    for (pl = visplanes ; pl < lastvisplane ; pl++)
+    for (i = 0 ; i < numvisplanes ; i++)
     {
+        pl = visplanes[i];
+
         if (pl->minx > pl->maxx)
             continue;
 
@@ -417,6 +537,7 @@ void R_DrawPlanes (void)
                     colfunc ();
                 }
             }
+            R_FlushColumns ();
             continue;
         }
 
@@ -35,6 +35,9 @@
 // Visplane related.
 extern  short*          lastopening;
 
+extern  int             numvisplanes;
+extern  int             maxvisplanes;
+
 
 typedef void (*planefunction_t) (int top, int bottom);
 
@@ -48,6 +51,9 @@ extern fixed_t          yslope[SCREENHEIGHT];
 extern fixed_t          distscale[SCREENWIDTH];
 
 void R_InitPlanes (void);
+void R_GrowPlanes (void);
+void R_CheckOpenings (int count);
+int R_OpeningsUsed (void);
 void R_ClearPlanes (void);
 
 void
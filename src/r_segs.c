@@ -29,6 +29,7 @@ rcsid[] = "$Id: r_segs.c,v 1.3 1997/01/29 20:10:19 b1 Exp $";
 #include <stdlib.h>
 
 #include "i_system.h"
+#include "z_zone.h"
 
 #include "doomdef.h"
 #include "doomstat.h"
@@ -184,9 +185,250 @@ R_RenderMaskedSegRange
         spryscale += rw_scalestep;
     }
 
+    R_FlushColumns ();
+
+}
+
+
+
+#ifdef DEFERWALLS
+//
+// Deferred wall columns.
+// Solid wall columns never overlap each other, nor the
+//  planes and sprites drawn after them, so they can be
+//  kept for the end of the BSP walk and drawn grouped
+//  by texture and light level. Consecutive columns then
+//  read from the same texture data and colormap.
+//
+#define MAXWALLCMDS             1024
+
+// colormaps 0-31, plus the fixed ones for invulnerability
+#define WALLLIGHTS              (NUMCOLORMAPS+2)
+
+typedef struct
+{
+    byte*               source;
+    lighttable_t*       colormap;
+    fixed_t             iscale;
+    fixed_t             texturemid;
+    short               x;
+    short               yl;
+    short               yh;
+    short               texheight;
+    short               texnum;
+    short               light;
+
+} wallcmd_t;
+
+static wallcmd_t*       wallcmds;
+static int*             wallorder;
+static int              numwallcmds;
+static int              maxwallcmds;
+
+static int*             walltexcount;
+static int              walllightcount[WALLLIGHTS];
+
+static void             (*wallnexthook) (void);
+
+
+//
+// R_GrowWallCmds
+// A zone purge may draw and empty the list
+//  while the new block is allocated.
+//
+static void R_GrowWallCmds (void)
+{
+    wallcmd_t*  newcmds;
+    int         newmax;
+
+    newmax = maxwallcmds ? maxwallcmds*2 : MAXWALLCMDS;
+    newcmds = Z_Malloc (newmax*(sizeof(*newcmds)+2*sizeof(int)),
+                        PU_STATIC, 0);
+
+    if (wallcmds)
+    {
+        memcpy (newcmds, wallcmds, numwallcmds*sizeof(*newcmds));
+        Z_Free (wallcmds);
+    }
+
+    wallcmds = newcmds;
+    wallorder = (int *)(newcmds + newmax);
+    maxwallcmds = newmax;
+}
+
+
+//
+// R_DeferWallColumn
+// Records the column set up in dc_* instead of drawing it.
+//
+static void R_DeferWallColumn (int texnum, int texturecolumn)
+{
+    wallcmd_t*  cmd;
+    byte*       source;
+
+    // grow first, a purge while growing could throw out
+    //  the block source points into
+    if (numwallcmds == maxwallcmds)
+        R_GrowWallCmds ();
+
+    // may purge, and so draw the list
+    source = R_GetColumn (texnum, texturecolumn);
+
+    cmd = &wallcmds[numwallcmds++];
+    cmd->source = source;
+    cmd->colormap = dc_colormap;
+    cmd->iscale = dc_iscale;
+    cmd->texturemid = dc_texturemid;
+    cmd->x = dc_x;
+    cmd->yl = dc_yl;
+    cmd->yh = dc_yh;
+    cmd->texheight = dc_texheight;
+    cmd->texnum = texnum;
+    cmd->light = (dc_colormap - colormaps) >> 8;
+}
+
+
+//
+// R_DrawWalls
+// Draws the recorded columns, sorted by texture,
+//  then light level, then in the order they came.
+//
+void R_DrawWalls (void)
+{
+    int*        order;
+    int         i;
+    int         n;
+    int         sum;
+    wallcmd_t*  cmd;
+
+    if (!numwallcmds)
+        return;
+
+    order = wallorder + maxwallcmds;
+
+    // counting sort on light level into order
+    memset (walllightcount, 0, sizeof(walllightcount));
+    for (i=0 ; i<numwallcmds ; i++)
+        walllightcount[wallcmds[i].light]++;
+
+    for (i=0, sum=0 ; i<WALLLIGHTS ; i++)
+    {
+        n = walllightcount[i];
+        walllightcount[i] = sum;
+        sum += n;
+    }
+
+    for (i=0 ; i<numwallcmds ; i++)
+        order[walllightcount[wallcmds[i].light]++] = i;
+
+    // then stable on texture into wallorder
+    memset (walltexcount, 0, numtextures*sizeof(*walltexcount));
+    for (i=0 ; i<numwallcmds ; i++)
+        walltexcount[wallcmds[i].texnum]++;
+
+    for (i=0, sum=0 ; i<numtextures ; i++)
+    {
+        n = walltexcount[i];
+        walltexcount[i] = sum;
+        sum += n;
+    }
+
+    for (i=0 ; i<numwallcmds ; i++)
+        wallorder[walltexcount[wallcmds[order[i]].texnum]++] = order[i];
+
+    for (i=0 ; i<numwallcmds ; i++)
+    {
+        cmd = &wallcmds[wallorder[i]];
+        dc_source = cmd->source;
+        dc_colormap = cmd->colormap;
+        dc_iscale = cmd->iscale;
+        dc_texturemid = cmd->texturemid;
+        dc_x = cmd->x;
+        dc_yl = cmd->yl;
+        dc_yh = cmd->yh;
+        dc_texheight = cmd->texheight;
+        colfunc ();
+    }
+
+    R_FlushColumns ();
+
+    dc_texheight = 128;
+    numwallcmds = 0;
+}
+
+
+//
+// R_PurgeWalls
+// Hooked on zone purges, as the recorded columns
+//  point into cached textures and patches.
+// This can come from R_GetColumn in the middle
+//  of setting up a column, so dc_* are kept.
+//
+static void R_PurgeWalls (void)
+{
+    lighttable_t*       colormap;
+    fixed_t             iscale;
+    fixed_t             texturemid;
+    int                 x;
+    int                 yl;
+    int                 yh;
+    int                 texheight;
+
+    if (numwallcmds)
+    {
+        colormap = dc_colormap;
+        iscale = dc_iscale;
+        texturemid = dc_texturemid;
+        x = dc_x;
+        yl = dc_yl;
+        yh = dc_yh;
+        texheight = dc_texheight;
+
+        R_DrawWalls ();
+
+        dc_colormap = colormap;
+        dc_iscale = iscale;
+        dc_texturemid = texturemid;
+        dc_x = x;
+        dc_yl = yl;
+        dc_yh = yh;
+        dc_texheight = texheight;
+    }
+
+    if (wallnexthook)
+        wallnexthook ();
 }
 
 
+//
+// R_InitWalls
+// Called by R_Init, after the textures are loaded.
+//
+void R_InitWalls (void)
+{
+    walltexcount = Z_Malloc (numtextures*sizeof(*walltexcount),
+                             PU_STATIC, 0);
+    R_GrowWallCmds ();
+
+    wallnexthook = zpurgehook;
+    zpurgehook = R_PurgeWalls;
+}
+#endif
+
+
+//
+// R_WallColumn
+// Draws, or records, one tier of a wall column.
+//
+static inline void R_WallColumn (int texnum, int texturecolumn)
+{
+#ifdef DEFERWALLS
+    R_DeferWallColumn (texnum, texturecolumn);
+#else
+    dc_source = R_GetColumn (texnum, texturecolumn);
+    colfunc ();
+#endif
+}
 
 
 //
@@ -210,9 +452,21 @@ void R_RenderSegLoop (void)
     fixed_t             texturecolumn;
     int                 top;
     int                 bottom;
+#ifdef TALLWALLS
+    int                 midheight;
+    int                 topheight;
+    int                 bottomheight;
+#endif
 
     //texturecolumn = 0;                                // shut up compiler warning
 
+#ifdef TALLWALLS
+    // tiers wrap at their own texture height
+    midheight = textureheight[midtexture]>>FRACBITS;
+    topheight = textureheight[toptexture]>>FRACBITS;
+    bottomheight = textureheight[bottomtexture]>>FRACBITS;
+#endif
+
     for ( ; rw_x < rw_stopx ; rw_x++)
     {
         // mark floor / ceiling areas
@@ -280,8 +534,10 @@ void R_RenderSegLoop (void)
             dc_yl = yl;
             dc_yh = yh;
             dc_texturemid = rw_midtexturemid;
-            dc_source = R_GetColumn(midtexture,texturecolumn);
-            colfunc ();
+#ifdef TALLWALLS
+            dc_texheight = midheight;
+#endif
+            R_WallColumn (midtexture, texturecolumn);
             ceilingclip[rw_x] = viewheight;
             floorclip[rw_x] = -1;
         }
@@ -302,8 +558,10 @@ void R_RenderSegLoop (void)
                     dc_yl = yl;
                     dc_yh = mid;
                     dc_texturemid = rw_toptexturemid;
-                    dc_source = R_GetColumn(toptexture,texturecolumn);
-                    colfunc ();
+#ifdef TALLWALLS
+                    dc_texheight = topheight;
+#endif
+                    R_WallColumn (toptexture, texturecolumn);
                     ceilingclip[rw_x] = mid;
                 }
                 else
@@ -331,9 +589,10 @@ void R_RenderSegLoop (void)
                     dc_yl = mid;
                     dc_yh = yh;
                     dc_texturemid = rw_bottomtexturemid;
-                    dc_source = R_GetColumn(bottomtexture,
-                                            texturecolumn);
-                    colfunc ();
+#ifdef TALLWALLS
+                    dc_texheight = bottomheight;
+#endif
+                    R_WallColumn (bottomtexture, texturecolumn);
                     floorclip[rw_x] = mid;
                 }
                 else
@@ -358,6 +617,10 @@ void R_RenderSegLoop (void)
         topfrac += topstep;
         bottomfrac += bottomstep;
     }
+
+    R_FlushColumns ();
+
+    dc_texheight = 128;
 }
 
 
@@ -379,9 +642,8 @@ R_StoreWallRange
     fixed_t             vtop;
     int                 lightnum;
 
-    // don't overflow and crash
-    if (ds_p == &drawsegs[MAXDRAWSEGS])
-        return;
+    if (ds_p - drawsegs == maxdrawsegs)
+        R_GrowDrawSegs ();
 
 #ifdef RANGECHECK
     if (start >=viewwidth || start > stop)
@@ -605,6 +867,7 @@ R_StoreWallRange
         {
             // masked midtexture
             maskedtexture = true;
+            R_CheckOpenings (rw_stopx - rw_x);
             ds_p->maskedtexturecol = maskedtexturecol = lastopening - rw_x;
             lastopening += rw_stopx - rw_x;
         }
@@ -715,6 +978,7 @@ R_StoreWallRange
     if ( ((ds_p->silhouette & SIL_TOP) || maskedtexture)
          && !ds_p->sprtopclip)
     {
+        R_CheckOpenings (rw_stopx - start);
         memcpy (lastopening, ceilingclip+start, 2*(rw_stopx-start));
         ds_p->sprtopclip = lastopening - start;
         lastopening += rw_stopx - start;
@@ -723,6 +987,7 @@ R_StoreWallRange
     if ( ((ds_p->silhouette & SIL_BOTTOM) || maskedtexture)
          && !ds_p->sprbottomclip)
     {
+        R_CheckOpenings (rw_stopx - start);
         memcpy (lastopening, floorclip+start, 2*(rw_stopx-start));
         ds_p->sprbottomclip = lastopening - start;
         lastopening += rw_stopx - start;
@@ -36,6 +36,11 @@ R_RenderMaskedSegRange
   int           x1,
   int           x2 );
 
+#ifdef DEFERWALLS
+void R_InitWalls (void);
+void R_DrawWalls (void);
+#endif
+
 
 #endif
 //-----------------------------------------------------------------------------
@@ -44,6 +44,9 @@
 // needed for texture pegging
 extern fixed_t*         textureheight;
 
+// needed for sorting deferred walls by texture
+extern int              numtextures;
+
 // needed for pre rendering (fracs)
 extern fixed_t*         spritewidth;
 
@@ -0,0 +1,329 @@
+// Emacs style mode select   -*- C++ -*-
+//-----------------------------------------------------------------------------
+//
+// $Id:$
+//
+// Copyright (C) 1993-1996 by id Software, Inc.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// $Log:$
+//
+// DESCRIPTION:
+//      Threaded strip renderer.
+//      The BSP walk, seg clipping and sprite sorting stay on the
+//       main thread, which only records the columns and spans
+//       it would have drawn. The view is split in vertical strips,
+//       one per worker, and each worker replays the whole list
+//       clipped to its strip. Every pixel is thus written in the
+//       same order as by the single threaded path.
+//      Experimental: scaling with the number of cores has not
+//       been measured yet (see doc/benchmarks.md).
+//
+//-----------------------------------------------------------------------------
+
+static const char __attribute__((unused))
+rcsid[] = "$Id: m_bbox.c,v 1.1 1997/02/03 22:45:10 b1 Exp $";
+
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "doomdef.h"
+
+#include "i_system.h"
+#include "z_zone.h"
+#include "m_argv.h"
+
+#include "r_local.h"
+#include "r_strip.h"
+
+
+#ifdef RENDERTHREADS
+
+typedef enum
+{
+    SC_COLUMN,
+    SC_FUZZCOLUMN,
+    SC_TRANSCOLUMN,
+    SC_SPAN
+
+} stripcmdtype_t;
+
+typedef struct
+{
+    lighttable_t*       colormap;
+    byte*               source;
+    byte*               translation;
+    int                 x;
+    int                 yl;
+    int                 yh;
+    fixed_t             iscale;
+    fixed_t             texturemid;
+    int                 texheight;
+    int                 fuzzpos;
+
+} stripcolumn_t;
+
+typedef struct
+{
+    lighttable_t*       colormap;
+    byte*               source;
+    int                 y;
+    int                 x1;
+    int                 x2;
+    fixed_t             xfrac;
+    fixed_t             yfrac;
+    fixed_t             xstep;
+    fixed_t             ystep;
+
+} stripspan_t;
+
+typedef struct
+{
+    stripcmdtype_t      type;
+
+    union
+    {
+        stripcolumn_t   column;
+        stripspan_t     span;
+    } u;
+
+} stripcmd_t;
+
+
+int                     numstrips;
+
+// Kept out of the zone, it can grow while the zone
+//  is in the middle of purging (see R_FlushStrips).
+static stripcmd_t*      stripcmds;
+static int              numstripcmds;
+static int              maxstripcmds;
+
+
+//
+// R_NewStripCmd
+//
+static stripcmd_t* R_NewStripCmd (stripcmdtype_t type)
+{
+    stripcmd_t*         cmd;
+
+    if (numstripcmds == maxstripcmds)
+    {
+        maxstripcmds = maxstripcmds ? maxstripcmds*2 : 4096;
+        stripcmds = realloc (stripcmds, maxstripcmds*sizeof(*stripcmds));
+
+        if (!stripcmds)
+            I_Error ("R_NewStripCmd: no memory for %i commands",
+                     maxstripcmds);
+    }
+
+    cmd = &stripcmds[numstripcmds++];
+    cmd->type = type;
+
+    return cmd;
+}
+
+
+//
+// R_RecordColumnCmd
+// Snapshot of the dc_ state for one column.
+//
+static stripcolumn_t* R_RecordColumnCmd (stripcmdtype_t type)
+{
+    stripcolumn_t*      col;
+
+    col = &R_NewStripCmd (type)->u.column;
+
+    col->colormap = dc_colormap;
+    col->source = dc_source;
+    col->translation = dc_translation;
+    col->x = dc_x;
+    col->yl = dc_yl;
+    col->yh = dc_yh;
+    col->iscale = dc_iscale;
+    col->texturemid = dc_texturemid;
+    col->texheight = dc_texheight;
+
+    return col;
+}
+
+
+static void R_RecordColumn (void)
+{
+    if (dc_yh >= dc_yl)
+        R_RecordColumnCmd (SC_COLUMN);
+}
+
+
+static void R_RecordTranslatedColumn (void)
+{
+    if (dc_yh >= dc_yl)
+        R_RecordColumnCmd (SC_TRANSCOLUMN);
+}
+
+
+//
+// R_RecordFuzzColumn
+// fuzzpos runs across columns, so each one
+//  keeps where it starts in the sequence.
+//
+static void R_RecordFuzzColumn (void)
+{
+    R_RecordColumnCmd (SC_FUZZCOLUMN)->fuzzpos = fuzzpos;
+    R_SkipFuzzColumn ();
+}
+
+
+static void R_RecordSpan (void)
+{
+    stripspan_t*        span;
+
+    span = &R_NewStripCmd (SC_SPAN)->u.span;
+
+    span->colormap = ds_colormap;
+    span->source = ds_source;
+    span->y = ds_y;
+    span->x1 = ds_x1;
+    span->x2 = ds_x2;
+    span->xfrac = ds_xfrac;
+    span->yfrac = ds_yfrac;
+    span->xstep = ds_xstep;
+    span->ystep = ds_ystep;
+}
+
+
+//
+// R_StripWorker
+// Draws whatever falls in this worker's strip.
+// The dc_ and ds_ globals are thread local here.
+//
+static void R_StripWorker (int worker)
+{
+    stripcmd_t*         cmd;
+    stripcmd_t*         end;
+    stripcolumn_t*      col;
+    stripspan_t*        span;
+    int                 x1;
+    int                 x2;
+
+    x1 = worker*viewwidth/numstrips;
+    x2 = (worker+1)*viewwidth/numstrips - 1;
+
+    end = stripcmds + numstripcmds;
+
+    for (cmd = stripcmds ; cmd < end ; cmd++)
+    {
+        if (cmd->type == SC_SPAN)
+        {
+            span = &cmd->u.span;
+
+            if (span->x2 < x1 || span->x1 > x2)
+                continue;
+
+            ds_colormap = span->colormap;
+            ds_source = span->source;
+            ds_y = span->y;
+            ds_x1 = span->x1;
+            ds_x2 = span->x2;
+            ds_xfrac = span->xfrac;
+            ds_yfrac = span->yfrac;
+            ds_xstep = span->xstep;
+            ds_ystep = span->ystep;
+
+            R_DrawSpanRange (ds_x1 < x1 ? x1 : ds_x1,
+                             ds_x2 > x2 ? x2 : ds_x2);
+            continue;
+        }
+
+        col = &cmd->u.column;
+
+        if (col->x < x1 || col->x > x2)
+            continue;
+
+        dc_colormap = col->colormap;
+        dc_source = col->source;
+        dc_translation = col->translation;
+        dc_x = col->x;
+        dc_yl = col->yl;
+        dc_yh = col->yh;
+        dc_iscale = col->iscale;
+        dc_texturemid = col->texturemid;
+        dc_texheight = col->texheight;
+
+        switch (cmd->type)
+        {
+          case SC_FUZZCOLUMN:
+            fuzzpos = col->fuzzpos;
+            R_DrawFuzzColumn ();
+            break;
+
+          case SC_TRANSCOLUMN:
+            R_DrawTranslatedColumn ();
+            break;
+
+          default:
+            R_DrawColumn ();
+            break;
+        }
+    }
+}
+
+
+//
+// R_FlushStrips
+// Also hooked on zone purges, as recorded columns
+//  point into cached textures, patches and flats.
+//
+void R_FlushStrips (void)
+{
+    if (!numstripcmds)
+        return;
+
+    I_RunWorkers ();
+
+    numstripcmds = 0;
+}
+
+
+//
+// R_StripFuncs
+//
+void R_StripFuncs (void)
+{
+    colfunc = basecolfunc = R_RecordColumn;
+    fuzzcolfunc = R_RecordFuzzColumn;
+    transcolfunc = R_RecordTranslatedColumn;
+    spanfunc = R_RecordSpan;
+}
+
+
+//
+// R_InitStrips
+//
+void R_InitStrips (void)
+{
+    int         p;
+
+    p = M_CheckParm ("-rthreads");
+
+    if (!p || p >= myargc-1)
+        return;
+
+    numstrips = I_StartWorkers (atoi (myargv[p+1]), R_StripWorker);
+
+    if (numstrips)
+        zpurgehook = R_FlushStrips;
+
+    printf ("\nR_InitStrips: %i threads (experimental)", numstrips);
+}
+
+#endif
@@ -0,0 +1,56 @@
+// Emacs style mode select   -*- C++ -*-
+//-----------------------------------------------------------------------------
+//
+// $Id:$
+//
+// Copyright (C) 1993-1996 by id Software, Inc.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//      Threaded strip renderer, columns and spans drawn by workers.
+//
+//-----------------------------------------------------------------------------
+
+
+#ifndef __R_STRIP__
+#define __R_STRIP__
+
+
+#ifdef __GNUG__
+#pragma interface
+#endif
+
+
+#ifdef RENDERTHREADS
+
+// Number of strips (and worker threads), 0 if not in use.
+extern int              numstrips;
+
+// Called by R_Init, starts the workers if -rthreads is given.
+void R_InitStrips (void);
+
+// Called by R_ExecuteSetViewSize in high detail,
+//  replaces the column and span functions with recording ones.
+void R_StripFuncs (void);
+
+// Has the workers draw everything recorded so far.
+void R_FlushStrips (void);
+
+#endif
+
+
+#endif
+//-----------------------------------------------------------------------------
+//
+// $Log:$
+//
+//-----------------------------------------------------------------------------
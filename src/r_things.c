@@ -286,8 +286,9 @@ void R_InitSpriteDefs (char** namelist)
 //
 // GAME FUNCTIONS
 //
-vissprite_t     vissprites[MAXVISSPRITES];
+vissprite_t*    vissprites;
 vissprite_t*    vissprite_p;
+int             maxvissprites;
 int             newvissprite;
 
 
@@ -322,13 +323,29 @@ void R_ClearSprites (void)
 
 //
 // R_NewVisSprite
+// Doubles vissprites when full, they are only
+//  linked together once all are projected.
 //
-vissprite_t     overflowsprite;
-
 vissprite_t* R_NewVisSprite (void)
 {
-    if (vissprite_p == &vissprites[MAXVISSPRITES])
-        return &overflowsprite;
+    vissprite_t*        newsprites;
+    int                 newmax;
+
+    if (vissprite_p - vissprites == maxvissprites)
+    {
+        newmax = maxvissprites ? maxvissprites*2 : MAXVISSPRITES;
+        newsprites = Z_Malloc (newmax*sizeof(*newsprites), PU_STATIC, 0);
+
+        if (vissprites)
+        {
+            memcpy (newsprites, vissprites, maxvissprites*sizeof(*newsprites));
+            Z_Free (vissprites);
+        }
+
+        vissprite_p = newsprites + (vissprite_p - vissprites);
+        vissprites = newsprites;
+        maxvissprites = newmax;
+    }
 
     vissprite_p++;
     return vissprite_p-1;
@@ -416,7 +433,7 @@ R_DrawVisSprite
     }
     else if (vis->mobjflags & MF_TRANSLATION)
     {
-        colfunc = R_DrawTranslatedColumn;
+        colfunc = transcolfunc;
         dc_translation = translationtables - 256 +
             ( (vis->mobjflags & MF_TRANSLATION) >> (MF_TRANSSHIFT-8) );
     }
@@ -439,6 +456,8 @@ R_DrawVisSprite
         R_DrawMaskedColumn (column);
     }
 
+    R_FlushColumns ();
+
     colfunc = basecolfunc;
 }
 
@@ -778,8 +797,46 @@ void R_DrawPlayerSprites (void)
 
 
 
+//
+// R_MergeVisSprites
+// Merges two lists sorted by scale. On equal scales
+//  the first list wins, so the sort stays stable.
+//
+static vissprite_t*
+R_MergeVisSprites
+( vissprite_t*  a,
+  vissprite_t*  b )
+{
+    vissprite_t         head;
+    vissprite_t*        tail;
+
+    tail = &head;
+
+    while (a && b)
+    {
+        if (b->scale < a->scale)
+        {
+            tail->next = b;
+            b = b->next;
+        }
+        else
+        {
+            tail->next = a;
+            a = a->next;
+        }
+        tail = tail->next;
+    }
+
+    tail->next = a ? a : b;
+
+    return head.next;
+}
+
+
 //
 // R_SortVisSprites
+// Bottom up merge sort, back to front with equal
+//  scales kept in projection order.
 //
 vissprite_t     vsprsortedhead;
 
@@ -787,55 +844,116 @@ vissprite_t     vsprsortedhead;
 void R_SortVisSprites (void)
 {
     int                 i;
-    int                 count;
     vissprite_t*        ds;
-    vissprite_t*        best;
-    vissprite_t         unsorted;
-    fixed_t             bestscale;
-
-    count = vissprite_p - vissprites;
-
-    unsorted.next = unsorted.prev = &unsorted;
+    vissprite_t*        list;
+    vissprite_t*        prev;
+    vissprite_t*        bins[32];
 
-    if (!count)
+    if (vissprite_p == vissprites)
         return;
 
+    // bins[i] holds a sorted run of 1<<i sprites,
+    //  always older than the ones merged into it
+    memset (bins, 0, sizeof(bins));
+
     for (ds=vissprites ; ds<vissprite_p ; ds++)
     {
-        ds->next = ds+1;
-        ds->prev = ds-1;
+        list = ds;
+        list->next = NULL;
+
+        for (i=0 ; bins[i] ; i++)
+        {
+            list = R_MergeVisSprites (bins[i], list);
+            bins[i] = NULL;
+        }
+        bins[i] = list;
     }
 
-    vissprites[0].prev = &unsorted;
-    unsorted.next = &vissprites[0];
-    (vissprite_p-1)->next = &unsorted;
-    unsorted.prev = vissprite_p-1;
+    list = NULL;
+    for (i=0 ; i<32 ; i++)
+    {
+        if (bins[i])
+            list = R_MergeVisSprites (bins[i], list);
+    }
 
-    // pull the vissprites out by scale
-    //best = 0;         // shut up the compiler warning
-    vsprsortedhead.next = vsprsortedhead.prev = &vsprsortedhead;
-    for (i=0 ; i<count ; i++)
+    // relink as a ring on vsprsortedhead
+    prev = &vsprsortedhead;
+    for (ds=list ; ds ; ds=ds->next)
     {
-        bestscale = MAXINT;
-        for (ds=unsorted.next ; ds!= &unsorted ; ds=ds->next)
-        {
-            if (ds->scale < bestscale)
-            {
-                bestscale = ds->scale;
-                best = ds;
-            }
-        }
-        best->next->prev = best->prev;
-        best->prev->next = best->next;
-        best->next = &vsprsortedhead;
-        best->prev = vsprsortedhead.prev;
-        vsprsortedhead.prev->next = best;
-        vsprsortedhead.prev = best;
+        ds->prev = prev;
+        prev->next = ds;
+        prev = ds;
     }
+    prev->next = &vsprsortedhead;
+    vsprsortedhead.prev = prev;
 }
 
 
 
+//
+// Drawseg index for sprite clipping.
+// The screen is split in DSBUCKETS column ranges, each listing
+//  the drawsegs that can clip sprites and overlap it, oldest first.
+//
+#define DSBUCKETSHIFT   5
+#define DSBUCKETS       ((SCREENWIDTH+(1<<DSBUCKETSHIFT)-1)>>DSBUCKETSHIFT)
+
+static drawseg_t**      dsindex;
+static int              maxdsindex;
+static int              dsbucketstart[DSBUCKETS+1];
+
+
+//
+// R_IndexDrawSegs
+// Once per frame, after the BSP is done.
+//
+static void R_IndexDrawSegs (void)
+{
+    drawseg_t*          ds;
+    int                 fill[DSBUCKETS];
+    int                 total;
+    int                 b;
+
+    memset (fill, 0, sizeof(fill));
+
+    for (ds=drawsegs ; ds<ds_p ; ds++)
+    {
+        if (!ds->silhouette && !ds->maskedtexturecol)
+            continue;
+
+        for (b=ds->x1>>DSBUCKETSHIFT ; b<=ds->x2>>DSBUCKETSHIFT ; b++)
+            fill[b]++;
+    }
+
+    total = 0;
+    for (b=0 ; b<DSBUCKETS ; b++)
+    {
+        dsbucketstart[b] = total;
+        total += fill[b];
+        fill[b] = dsbucketstart[b];
+    }
+    dsbucketstart[DSBUCKETS] = total;
+
+    if (total > maxdsindex)
+    {
+        if (dsindex)
+            Z_Free (dsindex);
+
+        maxdsindex = total > maxdsindex*2 ? total : maxdsindex*2;
+        dsindex = Z_Malloc (maxdsindex*sizeof(*dsindex), PU_STATIC, 0);
+    }
+
+    for (ds=drawsegs ; ds<ds_p ; ds++)
+    {
+        if (!ds->silhouette && !ds->maskedtexturecol)
+            continue;
+
+        for (b=ds->x1>>DSBUCKETSHIFT ; b<=ds->x2>>DSBUCKETSHIFT ; b++)
+            dsindex[fill[b]++] = ds;
+    }
+}
+
+
 //
 // R_DrawSprite
 //
@@ -844,6 +962,10 @@ void R_DrawSprite (vissprite_t* spr)
     drawseg_t*          ds;
     short               clipbot[SCREENWIDTH];
     short               cliptop[SCREENWIDTH];
+    int                 dsnext[DSBUCKETS];
+    int                 b;
+    int                 b1;
+    int                 b2;
     int                 x;
     int                 r1;
     int                 r2;
@@ -854,11 +976,37 @@ void R_DrawSprite (vissprite_t* spr)
     for (x = spr->x1 ; x<=spr->x2 ; x++)
         clipbot[x] = cliptop[x] = -2;
 
+    b1 = spr->x1 >> DSBUCKETSHIFT;
+    b2 = spr->x2 >> DSBUCKETSHIFT;
+
+    for (b=b1 ; b<=b2 ; b++)
+        dsnext[b] = dsbucketstart[b+1];
+
     // Scan drawsegs from end to start for obscuring segs.
     // The first drawseg that has a greater scale
     //  is the clip seg.
-    for (ds=ds_p-1 ; ds >= drawsegs ; ds--)
+    // Only the buckets under the sprite are walked, merged
+    //  newest first so segs are met in the same order.
+    for ( ; ; )
     {
+        ds = NULL;
+        for (b=b1 ; b<=b2 ; b++)
+        {
+            if (dsnext[b] > dsbucketstart[b]
+                && (!ds || dsindex[dsnext[b]-1] > ds))
+                ds = dsindex[dsnext[b]-1];
+        }
+
+        if (!ds)
+            break;
+
+        for (b=b1 ; b<=b2 ; b++)
+        {
+            if (dsnext[b] > dsbucketstart[b]
+                && dsindex[dsnext[b]-1] == ds)
+                dsnext[b]--;
+        }
+
         // determine if the drawseg obscures the sprite
         if (ds->x1 > spr->x2
             || ds->x2 < spr->x1
@@ -964,6 +1112,8 @@ void R_DrawMasked (void)
 
     if (vissprite_p > vissprites)
     {
+        R_IndexDrawSegs ();
+
         // draw all vissprites back to front
         for (spr = vsprsortedhead.next ;
              spr != &vsprsortedhead ;
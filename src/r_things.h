@@ -31,8 +31,9 @@
 
 #define MAXVISSPRITES   128
 
-extern vissprite_t      vissprites[MAXVISSPRITES];
+extern vissprite_t*     vissprites;
 extern vissprite_t*     vissprite_p;
+extern int              maxvissprites;
 extern vissprite_t      vsprsortedhead;
 
 // Constant arrays used for psprite clipping
@@ -59,8 +59,10 @@ rcsid[] = "$Id: d_main.c,v 1.8 1997/02/03 22:45:09 b1 Exp $";
 #include "f_wipe.h"
 
 #include "m_argv.h"
+#include "m_bench.h"
 #include "m_misc.h"
 #include "m_menu.h"
+#include "m_profile.h"
 
 #include "i_system.h"
 #include "i_sound.h"
@@ -238,7 +240,9 @@ void D_Display (void)
             redrawsbar = true;
         if (inhelpscreensstate && !inhelpscreens)
             redrawsbar = true;              // just put away the help screen
+        M_ProfileStart (ps_stbar);
         ST_Drawer (viewheight == 200, redrawsbar );
+        M_ProfileStop (ps_stbar);
         fullscreen = viewheight == 200;
         break;
 
@@ -263,7 +267,11 @@ void D_Display (void)
         R_RenderPlayerView (&players[displayplayer]);
 
     if (gamestate == GS_LEVEL && gametic)
+    {
+        M_ProfileStart (ps_hud);
         HU_Drawer ();
+        M_ProfileStop (ps_hud);
+    }
 
     // clean up border stuff
     if (gamestate != oldgamestate && gamestate != GS_LEVEL)
@@ -307,14 +315,21 @@ void D_Display (void)
 
 
     // menus go directly to the screen
+    M_ProfileStart (ps_menu);
     M_Drawer ();          // menu is drawn even on top of everything
+    M_ProfileStop (ps_menu);
     NetUpdate ();         // send out any new accumulation
 
+    if (profoverlay && gamestate == GS_LEVEL && !automapactive)
+        M_ProfileDrawer ();
 
     // normal update
     if (!wipe)
     {
+        M_ProfileStart (ps_blit);
         I_FinishUpdate ();              // page flip or blit buffer
+        M_ProfileStop (ps_blit);
+        M_ProfileFrame ();
         return;
     }
 
@@ -335,7 +350,10 @@ void D_Display (void)
                                , 0, 0, SCREENWIDTH, SCREENHEIGHT, tics);
         I_UpdateNoBlit ();
         M_Drawer ();                            // menu is drawn even on top of wipes
+        M_ProfileStart (ps_blit);
         I_FinishUpdate ();                      // page flip or blit buffer
+        M_ProfileStop (ps_blit);
+        M_ProfileFrame ();
     } while (!done);
 }
 
@@ -361,8 +379,10 @@ void D_DoomLoop (void)
             G_BuildTiccmd (&netcmds[consoleplayer][maketic%BACKUPTICS]);
             if (advancedemo)
                 D_DoAdvanceDemo ();
+            M_ProfileStart (ps_tics);
             M_Ticker ();
             G_Ticker ();
+            M_ProfileStop (ps_tics);
             gametic++;
             maketic++;
         }
@@ -373,6 +393,8 @@ void D_DoomLoop (void)
 
         // Update display, next frame, with current state.
         D_Display ();
+
+        M_BenchFrame ();
     }
 }
 
@@ -580,6 +602,9 @@ void D_DoomMain (void)
     startmap     = 1;
     autostart    = false;
 
+    /* Frame profile on the console every 100 frames */
+    profreport   = 100;
+
     /* Custom title */
     printf ( "----------------------------\n"
              "RISC-V DOOM Startup v%i.%i\n"
@@ -596,6 +621,11 @@ void D_DoomMain (void)
     printf ("Z_Init: Init zone memory allocation daemon. \n");
     Z_Init ();
 
+#ifdef FIXEDBENCH
+    /* Time the fixed point helpers */
+    M_FixedBench ();
+#endif
+
     printf ("W_Init: Init WADfiles.\n");
     W_InitMultipleFiles (wadfiles);
 
@@ -623,6 +653,12 @@ void D_DoomMain (void)
     printf ("ST_Init: Init status bar.\n");
     ST_Init ();
 
+#ifdef BENCHMARK
+    /* Time demo1 to demo4, JSON results on the console */
+    M_StartBench (NULL, 0, false);
+    D_DoomLoop ();  // never returns
+#endif
+
     if ( gameaction != ga_loadgame )
     {
         if (autostart || netgame)
@@ -37,6 +37,7 @@
 
 #include "console.h"
 #include "config.h"
+#include "libc_backend.h"
 
 
 /* Video controller, used as a time base */
@@ -65,6 +66,14 @@ I_ZoneBase(int *size)
 }
 
 
+void *
+I_MapFile(int handle, int length)
+{
+	/* WAD is in XIP flash, lumps can be used in place */
+	return libc_fd_map(handle, length);
+}
+
+
 int
 I_GetTime(void)
 {
@@ -78,6 +87,28 @@ I_GetTime(void)
 	return (vt_base + vt_now) >> 1;
 }
 
+unsigned
+I_GetCycles(void)
+{
+	unsigned cycles;
+	asm volatile ("rdcycle %0" : "=r" (cycles));
+	return cycles;
+}
+
+unsigned
+I_GetInstructions(void)
+{
+	unsigned instrs;
+	asm volatile ("rdinstret %0" : "=r" (instrs));
+	return instrs;
+}
+
+char *
+I_CyclesUnit(void)
+{
+	return "cycles";
+}
+
 
 static void
 I_GetRemoteEvent(void)
@@ -74,20 +74,6 @@ I_FinishUpdate (void)
 		screens[0],
 		SCREENHEIGHT * SCREENWIDTH
 	);
-
-	/* Very crude FPS measure (time to render 100 frames */
-#if 1
-	static int frame_cnt = 0;
-	static int tick_prev = 0;
-
-	if (++frame_cnt == 100)
-	{
-		int tick_now = I_GetTime();
-		printf("%d\n", tick_now - tick_prev);
-		tick_prev = tick_now;
-		frame_cnt = 0;
-	}
-#endif
 }
 
 
@@ -28,6 +28,7 @@
 
 #include "config.h"
 #include "console.h"
+#include "libc_backend.h"
 
 
 #define LIBC_DEBUG
@@ -195,6 +196,19 @@ _lseek(int fd, off_t offset, int whence)
 	return new_offset;
 }
 
+void *
+libc_fd_map(int fd, size_t len)
+{
+	/* Files live in memory mapped flash, so just point to them */
+	if ((fd < 0) || (fd >= NUM_FDS) || (fds[fd].type != FD_FLASH))
+		return NULL;
+
+	if (len > fds[fd].len)
+		return NULL;
+
+	return fds[fd].data;
+}
+
 int
 _stat(const char *filename, struct stat *statbuf)
 {
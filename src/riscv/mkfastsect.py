@@ -0,0 +1,111 @@
+#!/usr/bin/env python3
+#
+# mkfastsect.py
+#
+# Places the hot code listed in hotlist.txt in fast RAM.
+#
+# Each symbol is in its own section (-ffunction-sections and
+# -fdata-sections), so the list only has to be turned into
+# input section statements that riscv.lds includes in the
+# .fast (PSRAM) and .fastbram (BRAM) output sections. start.S
+# copies them from ROM at boot.
+#
+# Usage: mkfastsect.py lds <hotlist.txt> <psram|bram> > fast_<region>.gen.ld
+#        mkfastsect.py report <hotlist.txt> <nm> <file.elf>
+#
+# Copyright (C) 2021 Sylvain Munaut
+# All rights reserved.
+#
+# This program is free software; you can redistribute it and/or
+# modify it under the terms of the GNU General Public License
+# as published by the Free Software Foundation; either version 2
+# of the License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+
+import subprocess
+import sys
+
+
+REGIONS = {
+	# region: (start symbol, end symbol)
+	'psram': ('_sfast',     '_efast'),
+	'bram':  ('_sfastbram', '_efastbram'),
+}
+
+# Input section prefixes a symbol can be in
+PREFIXES = [ '.text', '.rodata', '.srodata', '.data', '.sdata', '.bss', '.sbss' ]
+
+
+def load_hotlist(filename):
+	hot = []
+	with open(filename, 'r') as fh:
+		for l in fh:
+			l = l.split('#')[0].split()
+			if not l:
+				continue
+			region = l[1] if len(l) > 1 else 'psram'
+			if region not in REGIONS:
+				raise RuntimeError('Unknown region %s for %s' % (region, l[0]))
+			hot.append((l[0], region))
+	return hot
+
+
+def gen_lds(hot, region):
+	print('/* Generated by mkfastsect.py, do not edit */')
+	for name, r in hot:
+		if r != region:
+			continue
+		# LTO may rename local symbols to name.lto_priv.N
+		print('*(%s)' % ' '.join('%s.%s %s.%s.*' % (p, name, p, name) for p in PREFIXES))
+
+
+def gen_report(hot, nm, elf):
+	# Symbols, sorted by address, with sizes
+	out = subprocess.check_output([nm, '-S', '-n', elf]).decode()
+
+	syms = []
+	addr = {}
+	for l in out.splitlines():
+		f = l.split()
+		if len(f) == 4:
+			syms.append((int(f[0], 16), int(f[1], 16), f[3]))
+		elif len(f) == 3:
+			addr[f[2]] = int(f[0], 16)
+
+	placed = set()
+
+	for region, (sym_start, sym_end) in REGIONS.items():
+		start = addr.get(sym_start)
+		end   = addr.get(sym_end)
+		if start is None or end is None:
+			continue
+
+		print('%s: 0x%08x-0x%08x, %d bytes' % (region, start, end, end - start))
+		for a, s, name in syms:
+			if start <= a < end:
+				print('  0x%08x %6d  %s' % (a, s, name))
+				placed.add(name.split('.')[0])
+
+	missing = [ name for name, r in hot if name not in placed ]
+	if missing:
+		print('not placed (inlined, unused or misspelled): %s' % ' '.join(missing))
+
+
+def main(argv):
+	hot = load_hotlist(argv[2])
+
+	if argv[1] == 'lds':
+		gen_lds(hot, argv[3])
+	elif argv[1] == 'report':
+		gen_report(hot, argv[3], argv[4])
+	else:
+		raise RuntimeError('Unknown command %s' % argv[1])
+
+
+if __name__ == '__main__':
+	main(sys.argv)
@@ -0,0 +1,101 @@
+#!/usr/bin/env python3
+#
+# mkwadindex.py
+#
+# Generates the WAD directory as const tables so it can live in ROM
+# instead of being parsed into RAM at each boot (see W_InitIndex).
+#
+# Usage: mkwadindex.py <file.wad> <flash_address> > wadindex.gen.c
+#
+# Copyright (C) 2021 Sylvain Munaut
+# All rights reserved.
+#
+# This program is free software; you can redistribute it and/or
+# modify it under the terms of the GNU General Public License
+# as published by the Free Software Foundation; either version 2
+# of the License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+
+import struct
+import sys
+
+
+def name_hash(name):
+	# Must match W_LumpNameHash() in w_wad.c
+	v1, v2 = struct.unpack('<II', name)
+	h = ((v1 * 0x9e3779b1) ^ (v2 * 0x85ebca6b)) & 0xffffffff
+	return h ^ (h >> 15)
+
+
+def c_name(name):
+	# Octal escapes so nothing can run into the next char
+	return ''.join(chr(c) if (0x20 < c < 0x7f) and chr(c) not in '"\\?' else '\\%03o' % c for c in name.rstrip(b'\0'))
+
+
+def main(argv):
+	wad_file  = argv[1]
+	wad_addr  = int(argv[2], 0)
+
+	with open(wad_file, 'rb') as fh:
+		data = fh.read()
+
+	ident, numlumps, infotableofs = struct.unpack('<4sii', data[0:12])
+	if ident not in (b'IWAD', b'PWAD'):
+		raise RuntimeError('%s doesn\'t have IWAD or PWAD id' % wad_file)
+
+	# Directory, with names cleaned the same way W_AddFile does it
+	lumps = []
+	for i in range(numlumps):
+		pos, size, name = struct.unpack('<ii8s', data[infotableofs+16*i:infotableofs+16*(i+1)])
+		name = name.split(b'\0')[0].ljust(8, b'\0')
+		if pos + size > len(data):
+			raise RuntimeError('Lump %d is past the end of %s' % (i, wad_file))
+		lumps.append((name, pos, size))
+
+	# Hash chains, last lump of a given name first
+	hsize = 1
+	while hsize < numlumps:
+		hsize <<= 1
+
+	hashtab  = [-1] * hsize
+	hashnext = [-1] * numlumps
+
+	for i, (name, pos, size) in enumerate(lumps):
+		h = name_hash(name) & (hsize - 1)
+		hashnext[i] = hashtab[h]
+		hashtab[h] = i
+
+	# Output
+	print('/* Generated by mkwadindex.py from %s, do not edit */' % wad_file)
+	print()
+	print('#include "doomtype.h"')
+	print('#include "w_wad.h"')
+	print()
+	print('const int wadindex_numlumps = %d;' % numlumps)
+	print('const int wadindex_infotableofs = %d;' % infotableofs)
+	print('const void * const wadindex_base = (void*)0x%08x;' % wad_addr)
+	print('const unsigned wadindex_hashmask = 0x%x;' % (hsize - 1))
+	print()
+	print('const lumpinfo_t wadindex_lumpinfo[%d] = {' % numlumps)
+	for name, pos, size in lumps:
+		print('\t{ .name = "%s", .handle = -1, .position = %d, .size = %d, .data = (void*)0x%08x },' % (c_name(name), pos, size, wad_addr + pos))
+	print('};')
+	print()
+	print('const int wadindex_hash[%d] = {' % hsize)
+	for i in range(0, hsize, 16):
+		print('\t' + ' '.join('%d,' % v for v in hashtab[i:i+16]))
+	print('};')
+	print()
+	print('const int wadindex_hashnext[%d] = {' % numlumps)
+	for i in range(0, numlumps, 16):
+		print('\t' + ' '.join('%d,' % v for v in hashnext[i:i+16]))
+	print('};')
+
+
+if __name__ == '__main__':
+	main(sys.argv)
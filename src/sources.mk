@@ -13,11 +13,14 @@ SOURCES_doom := \
 	hu_stuff.c \
 	info.c \
 	m_argv.c \
+	m_bench.c \
 	m_bbox.c \
 	m_cheat.c \
 	m_fixed.c \
+	m_hash.c \
 	m_menu.c \
 	m_misc.c \
+	m_profile.c \
 	m_random.c \
 	m_swap.c \
 	p_ceilng.c \
@@ -46,6 +49,7 @@ SOURCES_doom := \
 	r_plane.c \
 	r_segs.c \
 	r_sky.c \
+	r_strip.c \
 	r_things.c \
 	sounds.c \
 	s_sound.c \
@@ -86,11 +90,14 @@ HEADERS_doom := \
 	i_system.h \
 	i_video.h \
 	m_argv.h \
+	m_bench.h \
 	m_bbox.h \
 	m_cheat.h \
 	m_fixed.h \
+	m_hash.h \
 	m_menu.h \
 	m_misc.h \
+	m_profile.h \
 	m_random.h \
 	m_swap.h \
 	p_inter.h \
@@ -110,6 +117,7 @@ HEADERS_doom := \
 	r_plane.h \
 	r_segs.h \
 	r_sky.h \
+	r_strip.h \
 	r_state.h \
 	r_things.h \
 	sounds.h \
@@ -49,6 +49,7 @@ rcsid[] = "$Id: st_stuff.c,v 1.6 1997/02/03 22:45:13 b1 Exp $";
 
 #include "am_map.h"
 #include "m_cheat.h"
+#include "m_profile.h"
 
 #include "s_sound.h"
 
@@ -464,6 +465,20 @@ unsigned char   cheat_mypos_seq[] =
 };
 
 
+// zone telemetry cheat
+unsigned char   cheat_zone_seq[] =
+{
+    0xb2, 0x26, 0x7a, 0xf6, 0x76, 0xa6, 0xff    // idzone
+};
+
+
+// frame profiler cheat
+unsigned char   cheat_prof_seq[] =
+{
+    0xb2, 0x26, 0x2a, 0x6a, 0xf6, 0x66, 0xff    // idprof
+};
+
+
 // Now what?
 cheatseq_t      cheat_mus = { cheat_mus_seq, 0 };
 cheatseq_t      cheat_god = { cheat_god_seq, 0 };
@@ -486,6 +501,8 @@ cheatseq_t      cheat_powerup[7] =
 cheatseq_t      cheat_choppers = { cheat_choppers_seq, 0 };
 cheatseq_t      cheat_clev = { cheat_clev_seq, 0 };
 cheatseq_t      cheat_mypos = { cheat_mypos_seq, 0 };
+cheatseq_t      cheat_zone = { cheat_zone_seq, 0 };
+cheatseq_t      cheat_prof = { cheat_prof_seq, 0 };
 
 
 //
@@ -671,6 +688,32 @@ ST_Responder (event_t* ev)
                 players[consoleplayer].mo->y);
         plyr->message = buf;
       }
+      // 'zone' dumps heap stats, and toggles streaming them
+      else if (cht_CheckCheat(&cheat_zone, ev->data1))
+      {
+        Z_PrintStats ();
+        W_PrintStats ();
+        R_PrintStats ();
+
+        zstatstics = zstatstics ? 0 : TICRATE;
+
+        if (zstatstics)
+          plyr->message = STSTR_ZONEON;
+        else
+          plyr->message = STSTR_ZONEOFF;
+      }
+      // 'prof' prints the frame profile, and toggles the overlay
+      else if (cht_CheckCheat(&cheat_prof, ev->data1))
+      {
+        M_ProfilePrint ();
+
+        profoverlay = !profoverlay;
+
+        if (profoverlay)
+          plyr->message = STSTR_PROFON;
+        else
+          plyr->message = STSTR_PROFOFF;
+      }
     }
 
     // 'clev' change-level cheat
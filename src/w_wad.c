@@ -63,6 +63,42 @@ int                     numlumps;
 
 void**                  lumpcache;
 
+// Name hash index, chains linked through lumphashnext.
+// Lumps are pushed at the head of their chain in
+//  directory order, so later files override earlier ones.
+static int*             lumphash;
+static int*             lumphashnext;
+static unsigned         lumphashmask;
+
+// Set when lumpinfo and the hash point at the const tables
+//  of the baked index (W_InitIndex), which may be in flash.
+// Nothing may write through them then.
+static boolean          lumpindexed;
+
+// Lookup statistics, see W_CheckNumForName.
+int                     lumplookups;
+int                     lumpprobes;
+
+// Purgable lumps read into the zone are kept on a LRU list,
+//  least recently used ones are evicted first when
+//  going over the budget or when the zone is full.
+// A budget of 0 leaves purging to the zone rover.
+#define LUMPCACHEBUDGET         (2*1024*1024)
+
+int                     lumpcachebudget = LUMPCACHEBUDGET;
+int                     lumpcachebytes;
+
+int                     lumpcachehits;
+int                     lumpcachemisses;
+int                     lumpcacheevictions;
+int                     lumpcachepurges;
+
+static int*             lrunext;
+static int*             lruprev;
+static int*             lrusize;        // -1 if not on the list
+static int              lruhead = -1;
+static int              lrutail = -1;
+
 
 #define strcmpi strcasecmp
 
@@ -151,6 +187,8 @@ void W_AddFile (char *filename)
     filelump_t*         fileinfo;
     filelump_t          singleinfo;
     int                 storehandle;
+    byte*               mapped;
+    int                 filelen;
 
     // open the file and add to directory
 
@@ -215,12 +253,29 @@ void W_AddFile (char *filename)
 
     storehandle = reloadname ? -1 : handle;
 
+    // see if the system can give us the file in place
+    mapped = NULL;
+    filelen = 0;
+
+    if (storehandle != -1)
+    {
+        filelen = lseek (handle, 0, SEEK_END);
+        if (filelen > 0)
+            mapped = I_MapFile (handle, filelen);
+    }
+
     for (i=startlump ; i<numlumps ; i++,lump_p++, fileinfo++)
     {
         lump_p->handle = storehandle;
         lump_p->position = LONG(fileinfo->filepos);
         lump_p->size = LONG(fileinfo->size);
         strncpy (lump_p->name, fileinfo->name, 8);
+
+        if (mapped
+            && lump_p->position + lump_p->size <= filelen)
+            lump_p->data = mapped + lump_p->position;
+        else
+            lump_p->data = NULL;
     }
 
     if (reloadname)
@@ -230,6 +285,192 @@ void W_AddFile (char *filename)
 
 
 
+//
+// W_LumpNameHash
+// Hash of a lump name given as its two 32 bit words.
+//
+static unsigned W_LumpNameHash (int v1, int v2)
+{
+    unsigned    h;
+
+    h = (unsigned)v1 * 0x9e3779b1 ^ (unsigned)v2 * 0x85ebca6b;
+    return h ^ (h >> 15);
+}
+
+
+//
+// W_HashLumps
+// (Re)builds the name hash index over lumpinfo.
+//
+void W_HashLumps (void)
+{
+    int         i;
+    unsigned    h;
+    int         size;
+
+    if (lumpindexed)
+        I_Error ("W_HashLumps: directory is a read only index");
+
+    free (lumphash);
+    free (lumphashnext);
+
+    // power of two, at least as many slots as lumps
+    for (size = 1 ; size < numlumps ; size <<= 1)
+        ;
+    lumphashmask = size - 1;
+
+    lumphash = malloc (size * sizeof(*lumphash));
+    lumphashnext = malloc (numlumps * sizeof(*lumphashnext));
+
+    if (!lumphash || !lumphashnext)
+        I_Error ("Couldn't allocate lump hash");
+
+    for (i=0 ; i<size ; i++)
+        lumphash[i] = -1;
+
+    for (i=0 ; i<numlumps ; i++)
+    {
+        h = W_LumpNameHash (*(int *)lumpinfo[i].name,
+                            *(int *)&lumpinfo[i].name[4]) & lumphashmask;
+        lumphashnext[i] = lumphash[h];
+        lumphash[h] = i;
+    }
+}
+
+
+
+//
+// LUMP CACHE LRU
+//
+
+//
+// W_UnlinkLump
+// Takes a lump off the LRU list.
+//
+static void W_UnlinkLump (int lump)
+{
+    if (lruprev[lump] == -1)
+        lruhead = lrunext[lump];
+    else
+        lrunext[lruprev[lump]] = lrunext[lump];
+
+    if (lrunext[lump] == -1)
+        lrutail = lruprev[lump];
+    else
+        lruprev[lrunext[lump]] = lruprev[lump];
+
+    lumpcachebytes -= lrusize[lump];
+    lrusize[lump] = -1;
+}
+
+
+//
+// W_TouchLump
+// Moves a cached lump to the head of the LRU list.
+//
+static void W_TouchLump (int lump)
+{
+    if (lrusize[lump] != -1)
+        W_UnlinkLump (lump);
+
+    lruprev[lump] = -1;
+    lrunext[lump] = lruhead;
+
+    if (lruhead == -1)
+        lrutail = lump;
+    else
+        lruprev[lruhead] = lump;
+
+    lruhead = lump;
+    lrusize[lump] = lumpinfo[lump].size;
+    lumpcachebytes += lrusize[lump];
+}
+
+
+//
+// W_EvictLump
+// Frees a cached lump if nobody holds it.
+// Lumps released with Z_ChangeTag to PU_CACHE
+//  can also be purged by the zone rover,
+//  they are just dropped off the list.
+//
+static boolean W_EvictLump (int lump)
+{
+    memblock_t* block;
+
+    if (!lumpcache[lump])
+    {
+        lumpcachepurges++;
+        W_UnlinkLump (lump);
+        return false;
+    }
+
+    block = (memblock_t *) ( (byte *)lumpcache[lump] - sizeof(memblock_t));
+
+    if (block->tag != PU_LUMPCACHE && block->tag < PU_PURGELEVEL)
+        return false;
+
+    lumpcacheevictions++;
+    W_UnlinkLump (lump);
+    Z_Free (lumpcache[lump]);
+
+    return true;
+}
+
+
+//
+// W_TrimCache
+// Makes room for size bytes within the budget.
+//
+static void W_TrimCache (int size)
+{
+    int         lump;
+    int         prev;
+
+    if (lumpcachebytes + size <= lumpcachebudget)
+        return;
+
+    // drop what the zone purged on its own first,
+    //  it would be accounted for otherwise
+    for (lump = lrutail ; lump != -1 ; lump = prev)
+    {
+        prev = lruprev[lump];
+        if (!lumpcache[lump])
+            W_EvictLump (lump);
+    }
+
+    for (lump = lrutail ;
+         lump != -1 && lumpcachebytes + size > lumpcachebudget ;
+         lump = prev)
+    {
+        prev = lruprev[lump];
+        W_EvictLump (lump);
+    }
+}
+
+
+//
+// W_ReclaimCache
+// Called by Z_Malloc when the zone is full,
+//  evicts the least recently used lump.
+//
+int W_ReclaimCache (void)
+{
+    int         lump;
+    int         prev;
+
+    for (lump = lrutail ; lump != -1 ; lump = prev)
+    {
+        prev = lruprev[lump];
+        if (W_EvictLump (lump))
+            return true;
+    }
+
+    return false;
+}
+
+
+
 //
 // W_Reload
 // Flushes any of the reloadable lumps in memory
@@ -248,6 +489,9 @@ void W_Reload (void)
     if (!reloadname)
         return;
 
+    if (lumpindexed)
+        I_Error ("W_Reload: directory is a read only index");
+
     if ( (handle = open (reloadname,O_RDONLY | O_BINARY)) == -1)
         I_Error ("W_Reload: couldn't open %s",reloadname);
 
@@ -266,6 +510,9 @@ void W_Reload (void)
          i<reloadlump+lumpcount ;
          i++,lump_p++, fileinfo++)
     {
+        if (lrusize[i] != -1)
+            W_UnlinkLump (i);
+
         if (lumpcache[i])
             Z_Free (lumpcache[i]);
 
@@ -274,10 +521,89 @@ void W_Reload (void)
     }
 
     close (handle);
+
+    W_HashLumps ();
 }
 
 
 
+//
+// W_LoadDirectory
+// Opens all the files, loads headers, and counts lumps.
+//
+void W_LoadDirectory (char** filenames)
+{
+    numlumps = 0;
+
+    // will be realloced as lumps are added
+    lumpinfo = malloc(1);
+
+    for ( ; *filenames ; filenames++)
+        W_AddFile (*filenames);
+
+    if (!numlumps)
+        I_Error ("W_InitFiles: no files found");
+
+    W_HashLumps ();
+}
+
+
+#ifdef WADINDEX
+//
+// Directory baked in ROM at build time,
+//  see riscv/mkwadindex.py.
+//
+extern const int                wadindex_numlumps;
+extern const int                wadindex_infotableofs;
+extern const void * const       wadindex_base;
+extern const unsigned           wadindex_hashmask;
+extern const lumpinfo_t         wadindex_lumpinfo[];
+extern const int                wadindex_hash[];
+extern const int                wadindex_hashnext[];
+
+
+//
+// W_InitIndex
+// Uses the baked directory if the only file given
+//  is the one it was built from, mapped where expected.
+//
+boolean W_InitIndex (char** filenames)
+{
+    wadinfo_t*  header;
+    int         handle;
+    int         length;
+
+    if (!filenames[0] || filenames[1] || filenames[0][0] == '~')
+        return false;
+
+    if ( (handle = open (filenames[0],O_RDONLY | O_BINARY)) == -1)
+        return false;
+
+    length = lseek (handle, 0, SEEK_END);
+    header = length > sizeof(wadinfo_t) ? I_MapFile (handle, length) : NULL;
+    close (handle);
+
+    if (header != wadindex_base
+        || LONG(header->numlumps) != wadindex_numlumps
+        || LONG(header->infotableofs) != wadindex_infotableofs)
+        return false;
+
+    printf (" using index of %s\n",filenames[0]);
+
+    // The casts drop const, lumpindexed keeps the
+    //  writers (W_Reload, W_HashLumps) off these.
+    lumpindexed = true;
+    numlumps = wadindex_numlumps;
+    lumpinfo = (lumpinfo_t *)wadindex_lumpinfo;
+    lumphash = (int *)wadindex_hash;
+    lumphashnext = (int *)wadindex_hashnext;
+    lumphashmask = wadindex_hashmask;
+
+    return true;
+}
+#endif
+
+
 //
 // W_InitMultipleFiles
 // Pass a null terminated list of files to use.
@@ -295,17 +621,10 @@ void W_InitMultipleFiles (char** filenames)
 {
     int         size;
 
-    // open all the files, load headers, and count lumps
-    numlumps = 0;
-
-    // will be realloced as lumps are added
-    lumpinfo = malloc(1);
-
-    for ( ; *filenames ; filenames++)
-        W_AddFile (*filenames);
-
-    if (!numlumps)
-        I_Error ("W_InitFiles: no files found");
+#ifdef WADINDEX
+    if (!W_InitIndex (filenames))
+#endif
+        W_LoadDirectory (filenames);
 
     // set up caching
     size = numlumps * sizeof(*lumpcache);
@@ -315,6 +634,18 @@ void W_InitMultipleFiles (char** filenames)
         I_Error ("Couldn't allocate lumpcache");
 
     memset (lumpcache,0, size);
+
+    // set up LRU list
+    lrunext = malloc (numlumps * sizeof(*lrunext));
+    lruprev = malloc (numlumps * sizeof(*lruprev));
+    lrusize = malloc (numlumps * sizeof(*lrusize));
+
+    if (!lrunext || !lruprev || !lrusize)
+        I_Error ("Couldn't allocate lump LRU");
+
+    memset (lrusize,-1, numlumps * sizeof(*lrusize));
+
+    zreclaim = W_ReclaimCache;
 }
 
 
@@ -360,6 +691,7 @@ int W_CheckNumForName (char* name)
 
     int         v1;
     int         v2;
+    int         i;
     lumpinfo_t* lump_p;
 
     // make the name into two integers for easy compares
@@ -374,17 +706,24 @@ int W_CheckNumForName (char* name)
     v1 = name8.x[0];
     v2 = name8.x[1];
 
+    lumplookups++;
 
-    // scan backwards so patch lump files take precedence
-    lump_p = lumpinfo + numlumps;
+    // chains are ordered last lump first,
+    //  so patch lump files take precedence
+    i = lumphash[W_LumpNameHash (v1, v2) & lumphashmask];
 
-    while (lump_p-- != lumpinfo)
+    while (i != -1)
     {
+        lumpprobes++;
+        lump_p = &lumpinfo[i];
+
         if ( *(int *)lump_p->name == v1
              && *(int *)&lump_p->name[4] == v2)
         {
-            return lump_p - lumpinfo;
+            return i;
         }
+
+        i = lumphashnext[i];
     }
 
     // TFB. Not found.
@@ -444,6 +783,12 @@ W_ReadLump
 
     l = lumpinfo+lump;
 
+    if (l->data)
+    {
+        memcpy (dest, l->data, l->size);
+        return;
+    }
+
     // ??? I_BeginRead ();
 
     if (l->handle == -1)
@@ -482,20 +827,50 @@ W_CacheLumpNum
     if ((unsigned)lump >= numlumps)
         I_Error ("W_CacheLumpNum: %i >= numlumps",lump);
 
+    // Directly addressable, no need to copy it in.
+    // Callers must not modify it. Only word aligned lumps
+    //  qualify, patches and map data are read as ints / shorts.
+    if (lumpinfo[lump].data && !((long)lumpinfo[lump].data & 3))
+        return lumpinfo[lump].data;
+
+    // purgable lumps are left to the LRU
+    if (lumpcachebudget && tag >= PU_PURGELEVEL)
+        tag = PU_LUMPCACHE;
+
     if (!lumpcache[lump])
     {
         // read the lump in
 
         //printf ("cache miss on lump %i\n",lump);
+        lumpcachemisses++;
+
+        // purged by the zone since last use
+        if (lrusize[lump] != -1)
+            W_EvictLump (lump);
+
+        if (lumpcachebudget)
+            W_TrimCache (W_LumpLength (lump));
+
         Z_Malloc (W_LumpLength (lump), tag, &lumpcache[lump]);
         W_ReadLump (lump, lumpcache[lump]);
     }
     else
     {
         //printf ("cache hit on lump %i\n",lump);
+        lumpcachehits++;
         Z_ChangeTag (lumpcache[lump],tag);
     }
 
+    // only lumps the LRU may evict count against the budget,
+    //  static and level lumps stay off the list
+    if (lumpcachebudget)
+    {
+        if (tag == PU_LUMPCACHE)
+            W_TouchLump (lump);
+        else if (lrusize[lump] != -1)
+            W_UnlinkLump (lump);
+    }
+
     return lumpcache[lump];
 }
 
@@ -513,6 +888,20 @@ W_CacheLumpName
 }
 
 
+//
+// W_PrintStats
+// Lump lookup and cache counters, next to Z_PrintStats.
+//
+void W_PrintStats (void)
+{
+    fprintf (stderr, "wad: lookups %i probes %i\n",
+             lumplookups, lumpprobes);
+    fprintf (stderr, "wad: cache %i/%i bytes hits %i misses %i evictions %i purges %i\n",
+             lumpcachebytes, lumpcachebudget, lumpcachehits,
+             lumpcachemisses, lumpcacheevictions, lumpcachepurges);
+}
+
+
 //
 // W_Profile
 //
@@ -541,7 +930,7 @@ void W_Profile (void)
         else
         {
             block = (memblock_t *) ( (byte *)ptr - sizeof(memblock_t));
-            if (block->tag < PU_PURGELEVEL)
+            if (block->tag < PU_PURGELEVEL && block->tag != PU_LUMPCACHE)
                 ch = 'S';
             else
                 ch = 'P';
@@ -60,6 +60,7 @@ typedef struct
     int         handle;
     int         position;
     int         size;
+    void*       data;   // directly addressable lump, NULL if read in
 } lumpinfo_t;
 
 
@@ -67,8 +68,23 @@ extern  void**          lumpcache;
 extern  lumpinfo_t*     lumpinfo;
 extern  int             numlumps;
 
+// W_CheckNumForName calls, and lumps compared by them.
+extern  int             lumplookups;
+extern  int             lumpprobes;
+
+// LRU lump cache, budget in bytes (0 to disable).
+extern  int             lumpcachebudget;
+extern  int             lumpcachebytes;
+extern  int             lumpcachehits;
+extern  int             lumpcachemisses;
+extern  int             lumpcacheevictions;
+extern  int             lumpcachepurges;
+
 void    W_InitMultipleFiles (char** filenames);
 void    W_Reload (void);
+void    W_HashLumps (void);
+int     W_ReclaimCache (void);
+void    W_PrintStats (void);
 
 int     W_CheckNumForName (char* name);
 int     W_GetNumForName (char* name);
@@ -42,8 +42,6 @@ rcsid[] = "$Id: z_zone.c,v 1.4 1997/02/03 16:47:58 b1 Exp $";
 //  because it will get overwritten automatically if needed.
 //
 
-#define ZONEID  0x1d4a11
-
 
 typedef struct
 {
@@ -62,6 +60,97 @@ typedef struct
 memzone_t*      mainzone;
 
 
+//
+// SMALL OBJECT POOLS
+// Unowned PU_LEVEL / PU_LEVSPEC allocations up to POOLMAX
+//  bytes (mobjs, sector thinkers, ...) are served from
+//  per tag, per size class free lists in O(1).
+// Pool objects keep a memblock_t header, with POOLID,
+//  so Z_Free and Z_ChangeTag accept them as usual.
+// Free lists are refilled by carving slabs out of the zone,
+//  tagged like their objects, so Z_FreeTags releases
+//  a whole pool at once.
+// Freed objects queue up behind the others and are only
+//  handed out again once POOLKEEP more of their class
+//  have been freed. Like with the plain zone, a stale
+//  pointer to a removed mobj keeps reading what the mobj
+//  held for a while, rather than the very next spawn.
+//
+#define POOLSHIFT       4
+#define POOLCLASSES     32
+#define POOLMAX         (POOLCLASSES << POOLSHIFT)
+#define POOLSLAB        4096
+#define POOLKEEP        32
+
+#define POOLTAGS        (PU_LEVSPEC - PU_LEVEL + 1)
+
+typedef struct
+{
+    memblock_t*         head;
+    memblock_t*         tail;
+    int                 count;  // objects on the list
+    int                 fresh;  // never used ones, at the head
+
+} zpool_t;
+
+static zpool_t          pools[POOLTAGS][POOLCLASSES];
+
+int             (*zreclaim) (void);
+void            (*zpurgehook) (void);
+
+
+//
+// TELEMETRY
+// Running counts are kept by Z_Malloc / Z_Free,
+//  the per tag breakdown and free space layout
+//  are gathered by walking the heap on demand.
+//
+int             zstatstics;
+
+static int      zallocs;        // heap blocks allocated, pool slabs included
+static int      zfrees;         // heap blocks freed, purges included
+static int      zpoolallocs;    // objects handed out by the pools
+static int      zpoolrecycles;  // of those, ones freed before
+static int      zpoolfrees;
+static int      zpurges;        // purgable blocks thrown out by Z_Malloc
+
+static int      zused;          // bytes in use, headers included
+static int      zusedmax;
+
+static int      zticallocs;     // during the last tic
+static int      zticfrees;
+static int      zticallocsmax;
+static int      zticfreesmax;
+static int      zlastallocs;
+static int      zlastfrees;
+static int      zticpoolallocs;
+static int      zticrecycles;
+static int      zticpoolallocsmax;
+static int      zticrecyclesmax;
+static int      zlastpoolallocs;
+static int      zlastrecycles;
+static int      ztics;
+
+static const struct
+{
+    int         tag;
+    char*       name;
+} ztagnames[] =
+{
+    { PU_STATIC,        "static" },
+    { PU_SOUND,         "sound" },
+    { PU_MUSIC,         "music" },
+    { PU_DAVE,          "dave" },
+    { PU_LUMPCACHE,     "lumps" },
+    { PU_LEVEL,         "level" },
+    { PU_LEVSPEC,       "levspec" },
+    { PU_PURGELEVEL,    "purge" },
+    { PU_CACHE,         "cache" },
+};
+
+#define NUMZTAGS        (sizeof(ztagnames)/sizeof(ztagnames[0]))
+
+
 
 //
 // Z_ClearZone
@@ -118,6 +207,96 @@ void Z_Init (void)
 }
 
 
+//
+// Z_InZone
+// Lumps mapped directly from the WAD (W_CacheLumpNum)
+//  are handed out without a zone block.
+//
+int Z_InZone (void* ptr)
+{
+    return (byte *)ptr > (byte *)mainzone
+        && (byte *)ptr < (byte *)mainzone + mainzone->size;
+}
+
+
+//
+// Z_PoolMalloc
+//
+static void* Z_PoolMalloc (int size, int tag)
+{
+    zpool_t*            pool;
+    memblock_t*         block;
+    byte*               slab;
+    int                 i;
+
+    // round up, header included, to the size class
+    size = (size + sizeof(memblock_t) + (1<<POOLSHIFT)-1) & ~((1<<POOLSHIFT)-1);
+    pool = &pools[tag - PU_LEVEL][(size >> POOLSHIFT) - 1];
+
+    if (!pool->fresh && pool->count <= POOLKEEP)
+    {
+        // carve a new slab into free objects, ahead of
+        //  the freed ones still kept back
+        slab = Z_Malloc (POOLSLAB, tag, NULL);
+
+        for (i = POOLSLAB - POOLSLAB % size - size ; i >= 0 ; i -= size)
+        {
+            block = (memblock_t *)(slab + i);
+            block->size = size;
+            block->id = 0;
+            block->next = pool->head;
+            pool->head = block;
+            if (!pool->tail)
+                pool->tail = block;
+            pool->count++;
+            pool->fresh++;
+        }
+    }
+
+    block = pool->head;
+    pool->head = block->next;
+    if (!pool->head)
+        pool->tail = NULL;
+    pool->count--;
+    if (pool->fresh)
+        pool->fresh--;
+    else
+        zpoolrecycles++;
+
+    // mark as in use, but unowned
+    block->user = (void *)2;
+    block->tag = tag;
+    block->id = POOLID;
+
+    zpoolallocs++;
+
+    return (void *) ((byte *)block + sizeof(memblock_t));
+}
+
+
+//
+// Z_PoolFree
+//
+static void Z_PoolFree (memblock_t* block)
+{
+    zpool_t*            pool;
+
+    pool = &pools[block->tag - PU_LEVEL][(block->size >> POOLSHIFT) - 1];
+
+    // to the back of the queue, the object itself is left alone
+    block->id = 0;
+    block->next = NULL;
+    if (pool->tail)
+        pool->tail->next = block;
+    else
+        pool->head = block;
+    pool->tail = block;
+    pool->count++;
+
+    zpoolfrees++;
+}
+
+
 //
 // Z_Free
 //
@@ -126,11 +305,28 @@ void Z_Free (void* ptr)
     memblock_t*         block;
     memblock_t*         other;
 
+    // directly mapped lump, nothing to free
+    if (!Z_InZone (ptr))
+        return;
+
     block = (memblock_t *) ( (byte *)ptr - sizeof(memblock_t));
 
+    if (block->id == POOLID)
+    {
+        Z_PoolFree (block);
+        return;
+    }
+
     if (block->id != ZONEID)
         I_Error ("Z_Free: freed a pointer without ZONEID");
 
+    if (zpurgehook
+        && (block->tag >= PU_PURGELEVEL || block->tag == PU_LUMPCACHE))
+        zpurgehook ();
+
+    zfrees++;
+    zused -= block->size;
+
     if (block->user > (void **)0x100)
     {
         // smaller values are not pointers
@@ -194,6 +390,12 @@ Z_Malloc
     memblock_t* newblock;
     memblock_t* base;
 
+    // small unowned level objects come from the pools
+    if (!user
+        && tag >= PU_LEVEL && tag <= PU_LEVSPEC
+        && size + sizeof(memblock_t) <= POOLMAX)
+        return Z_PoolMalloc (size, tag);
+
     size = (size + 3) & ~3;
 
     // scan through the block list,
@@ -219,7 +421,18 @@ Z_Malloc
         if (rover == start)
         {
             // scanned all the way around the list
-            I_Error ("Z_Malloc: failed on allocation of %i bytes", size);
+            if (!zreclaim || !zreclaim ())
+                I_Error ("Z_Malloc: failed on allocation of %i bytes", size);
+
+            // something got freed, start over
+            base = mainzone->rover;
+
+            if (!base->prev->user)
+                base = base->prev;
+
+            rover = base;
+            start = base->prev;
+            continue;
         }
 
         if (rover->user)
@@ -236,6 +449,7 @@ Z_Malloc
 
                 // the rover can be the base block
                 base = base->prev;
+                zpurges++;
                 Z_Free ((byte *)rover+sizeof(memblock_t));
                 base = base->next;
                 rover = base->next;
@@ -287,6 +501,11 @@ Z_Malloc
 
     base->id = ZONEID;
 
+    zallocs++;
+    zused += base->size;
+    if (zused > zusedmax)
+        zusedmax = zused;
+
     return (void *) ((byte *)base + sizeof(memblock_t));
 }
 
@@ -302,6 +521,7 @@ Z_FreeTags
 {
     memblock_t* block;
     memblock_t* next;
+    int         tag;
 
     for (block = mainzone->blocklist.next ;
          block != &mainzone->blocklist ;
@@ -317,6 +537,11 @@ Z_FreeTags
         if (block->tag >= lowtag && block->tag <= hightag)
             Z_Free ( (byte *)block+sizeof(memblock_t));
     }
+
+    // pool objects went away with their slabs
+    for (tag = PU_LEVEL ; tag <= PU_LEVSPEC ; tag++)
+        if (tag >= lowtag && tag <= hightag)
+            memset (pools[tag - PU_LEVEL], 0, sizeof(pools[0]));
 }
 
 
@@ -436,6 +661,14 @@ Z_ChangeTag2
 
     block = (memblock_t *) ( (byte *)ptr - sizeof(memblock_t));
 
+    if (block->id == POOLID)
+    {
+        // the object lives and dies with its slab
+        if (tag != block->tag)
+            I_Error ("Z_ChangeTag: can't change the tag of a pool object");
+        return;
+    }
+
     if (block->id != ZONEID)
         I_Error ("Z_ChangeTag: freed a pointer without ZONEID");
 
@@ -467,3 +700,90 @@ int Z_FreeMemory (void)
     return free;
 }
 
+
+
+//
+// Z_Ticker
+//
+void Z_Ticker (void)
+{
+    zticallocs = zallocs - zlastallocs;
+    zticfrees = zfrees - zlastfrees;
+    zlastallocs = zallocs;
+    zlastfrees = zfrees;
+    zticpoolallocs = zpoolallocs - zlastpoolallocs;
+    zticrecycles = zpoolrecycles - zlastrecycles;
+    zlastpoolallocs = zpoolallocs;
+    zlastrecycles = zpoolrecycles;
+
+    if (zticallocs > zticallocsmax)
+        zticallocsmax = zticallocs;
+    if (zticfrees > zticfreesmax)
+        zticfreesmax = zticfrees;
+    if (zticpoolallocs > zticpoolallocsmax)
+        zticpoolallocsmax = zticpoolallocs;
+    if (zticrecycles > zticrecyclesmax)
+        zticrecyclesmax = zticrecycles;
+
+    if (zstatstics && ++ztics >= zstatstics)
+    {
+        ztics = 0;
+        Z_PrintStats ();
+    }
+}
+
+
+
+//
+// Z_PrintStats
+// Heap usage by tag and free space fragmentation,
+//  on stderr (the UART console on riscv).
+//
+void Z_PrintStats (void)
+{
+    memblock_t*         block;
+    int                 tagused[NUMZTAGS+1];
+    int                 freebytes;
+    int                 fragments;
+    int                 largest;
+    int                 i;
+
+    memset (tagused, 0, sizeof(tagused));
+    freebytes = fragments = largest = 0;
+
+    for (block = mainzone->blocklist.next ;
+         block != &mainzone->blocklist;
+         block = block->next)
+    {
+        if (!block->user)
+        {
+            freebytes += block->size;
+            fragments++;
+            if (block->size > largest)
+                largest = block->size;
+            continue;
+        }
+
+        for (i=0 ; i<NUMZTAGS ; i++)
+            if (block->tag == ztagnames[i].tag)
+                break;
+
+        // anything unknown ends up in the last slot
+        tagused[i] += block->size;
+    }
+
+    fprintf (stderr, "zone: used %i/%i (max %i) free %i in %i frags, largest %i\n",
+             zused, mainzone->size, zusedmax, freebytes, fragments, largest);
+
+    fprintf (stderr, "zone:");
+    for (i=0 ; i<NUMZTAGS ; i++)
+        fprintf (stderr, " %s %i", ztagnames[i].name, tagused[i]);
+    fprintf (stderr, " other %i\n", tagused[NUMZTAGS]);
+
+    fprintf (stderr, "zone: allocs %i/tic (max %i) frees %i/tic (max %i) purges %i\n",
+             zticallocs, zticallocsmax, zticfrees, zticfreesmax, zpurges);
+
+    fprintf (stderr, "pools: allocs %i/tic (max %i) recycled %i/tic (max %i) total %i/%i/%i\n",
+             zticpoolallocs, zticpoolallocsmax, zticrecycles, zticrecyclesmax,
+             zpoolallocs, zpoolrecycles, zpoolfrees);
+}
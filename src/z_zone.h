@@ -38,6 +38,7 @@
 #define PU_SOUND                2       // static while playing
 #define PU_MUSIC                3       // static while playing
 #define PU_DAVE         4       // anything else Dave wants static
+#define PU_LUMPCACHE    5       // cached lump, evicted by the w_wad LRU
 #define PU_LEVEL                50      // static until level exited
 #define PU_LEVSPEC              51      // a special thinker in a level
 // Tags >= 100 are purgable whenever needed.
@@ -54,7 +55,27 @@ void    Z_FileDumpHeap (FILE *f);
 void    Z_CheckHeap (void);
 void    Z_ChangeTag2 (void *ptr, int tag);
 int     Z_FreeMemory (void);
+int     Z_InZone (void *ptr);
 
+// Zone telemetry.
+// Z_Ticker is called once per game tic, and prints
+//  Z_PrintStats every zstatstics tics if not 0.
+extern int      zstatstics;
+
+void    Z_Ticker (void);
+void    Z_PrintStats (void);
+
+// Called by Z_Malloc when no block is big enough,
+//  returns false if nothing more could be freed.
+extern int (*zreclaim) (void);
+
+// Called by Z_Free before a cached (purgable) block goes,
+//  for anyone still holding deferred pointers into it.
+extern void (*zpurgehook) (void);
+
+
+#define ZONEID          0x1d4a11
+#define POOLID          0x1d4a12        // small object from a pool
 
 typedef struct memblock_s
 {
@@ -69,12 +90,18 @@ typedef struct memblock_s
 //
 // This is used to get the local FILE:LINE info from CPP
 // prior to really call the function in question.
+// Pointers outside the zone (directly mapped lumps)
+// have no block header and are left alone.
 //
 #define Z_ChangeTag(p,t) \
 { \
-      if (( (memblock_t *)( (byte *)(p) - sizeof(memblock_t)))->id!=0x1d4a11) \
-          I_Error("Z_CT at "__FILE__":%i",__LINE__); \
+      if (Z_InZone(p)) \
+      { \
+          if (( (memblock_t *)( (byte *)(p) - sizeof(memblock_t)))->id!=ZONEID \
+              && ( (memblock_t *)( (byte *)(p) - sizeof(memblock_t)))->id!=POOLID) \
+              I_Error("Z_CT at "__FILE__":%i",__LINE__); \
           Z_ChangeTag2(p,t); \
+      } \
 };
 
 